@@ -16,6 +16,7 @@ using namespace std;
 #include "RecordDistribution.hxx"
 
 #include "Apriori.hxx"
+#include "Eclat.hxx"
 #include "StopIteDistrib.hxx"
 #include "Abs.hxx"
 
@@ -32,6 +33,7 @@ int main(int argc, char *argv[])
 
 if(argc < 3) {
     cerr << "usage: " << argv[0] << " datafile minsup(absolute)" << endl;
+    cerr << "\t -eclat            : use Eclat algorithm (depth first exploration)"<< endl;
     cerr << "\t -v                : print to screen"<< endl;
     cerr << "\t -th file_name     : save the theory in \"file_name\" "<< endl;
     cerr << "\t -bdp file_name    : save the positive border in \"file_name\" "<< endl;
@@ -41,6 +43,7 @@ else
 {
 
     bool verbose = false;
+    bool useEclat = false ;
     char * bdpfile = 0 ;
     char * bdnfile = 0 ;
     char * thfile = 0 ;
@@ -68,6 +71,8 @@ else
                i++ ;
           	   thfile = argv[ i ];
           }                  	               	            
+          else if( strcmp( argv[ i ], "-eclat") == 0 )
+               useEclat = true ;
                      
           i++ ;             
     }
@@ -148,15 +153,25 @@ else
     // Use an algorithm
     //******************************************************************************
     
-    // Declare algorith Apriori with 
-    //         int: the type of the itemsets
-    Apriori<int,SupportDisj > apriori;
-    
-    // To print screen informations about the exectution
-    apriori.verbose = verbose ;
-    
-    // exectue Apriori algorithm to find the boders
-    apriori( init, isfreqess, &distribth, &distribbdP, &distribbdN);
+    if( useEclat )
+    {
+        // Use Eclat algorithm, with the same parameters as Apriori
+        Eclat<int,SupportDisj > eclat;
+        eclat.verbose = verbose ;
+        eclat( init, isfreqess, &distribth, &distribbdP, &distribbdN);
+    }
+    else
+    {
+        // Declare algorith Apriori with 
+        //         int: the type of the itemsets
+        Apriori<int,SupportDisj > apriori;
+        
+        // To print screen informations about the exectution
+        apriori.verbose = verbose ;
+        
+        // exectue Apriori algorithm to find the boders
+        apriori( init, isfreqess, &distribth, &distribbdP, &distribbdN);
+    }
      
     
     // print to screen the distribution of Bd- 
@@ -15,12 +15,15 @@ using namespace std;
 #include "RecordDistribution.hxx"
 
 #include "Apriori.hxx"
+#include "Eclat.hxx"
+#include "FPGrowth.hxx"
+#include "FPMax.hxx"
 #include "StopIteDistrib.hxx"
 #include "Abs.hxx"
 
 //******************************************************************************
 // Example of main program for the discovery of the borders of the 
-// frequent itemsets using algorithms Apriori or ABS
+// frequent itemsets using algorithms Apriori, Eclat, FP-growth, FPMax or ABS
 //******************************************************************************
 
 int main(int argc, char *argv[])
@@ -29,6 +32,11 @@ int main(int argc, char *argv[])
 if(argc < 3) {
     cerr << "usage: " << argv[0] << " datafile minsup(absolute)" << endl;
     cerr << "\t -abs              : use ABS algorithm"<< endl;
+    cerr << "\t -reduce           : reduce the db after each level of Apriori"<< endl;
+    cerr << "\t -eclat            : use Eclat algorithm (depth first exploration)"<< endl;
+    cerr << "\t -fpgrowth         : use FP-growth algorithm (no candidate generation)"<< endl;
+    cerr << "\t -fpmax            : use FPMax algorithm (only the borders are searched)"<< endl;
+    cerr << "\t -mmcs             : compute the minimal transversals with MMCS in ABS"<< endl;
     cerr << "\t -v                : print to screen"<< endl;
     cerr << "\t -th file_name     : save the theory in \"file_name\" "<< endl;
     cerr << "\t -bdp file_name    : save the positive border in \"file_name\" "<< endl;
@@ -39,6 +47,11 @@ else
 
     bool verbose = false;
     bool useAbs = false ;
+    bool mmcs = false ;
+    bool useEclat = false ;
+    bool useFPGrowth = false ;
+    bool useFPMax = false ;
+    bool reduce = false ;
     bool bdp = false;
     bool bdn = false ;
     bool th = false ;
@@ -77,7 +90,17 @@ else
           	   thfile = argv[ i ];
           }    
           else if( strcmp( argv[ i ], "-abs") == 0 )
-               useAbs = true ;             	               	            
+               useAbs = true ;
+          else if( strcmp( argv[ i ], "-mmcs") == 0 )
+               mmcs = true ;
+          else if( strcmp( argv[ i ], "-eclat") == 0 )
+               useEclat = true ;
+          else if( strcmp( argv[ i ], "-fpgrowth") == 0 )
+               useFPGrowth = true ;
+          else if( strcmp( argv[ i ], "-fpmax") == 0 )
+               useFPMax = true ;
+          else if( strcmp( argv[ i ], "-reduce") == 0 )
+               reduce = true ;             	               	            
                      
           i++ ;             
     }
@@ -164,7 +187,30 @@ else
     // Use an algorithm
     //******************************************************************************    
     
-    if( !useAbs )
+    if( useFPMax )
+    {
+        // Use FPMax algorithm to find the borders without the theory
+        // (only with the predicate Frequent on a Tatree)
+        FPMax<int,Support > fpmax;
+        fpmax.verbose = verbose ;
+        fpmax( init, isfreq, distribbdP, distribbdN);
+    }
+    else if( useFPGrowth )
+    {
+        // Use FP-growth algorithm, with the same parameters as Apriori
+        // (only with the predicate Frequent on a Tatree)
+        FPGrowth<int,Support > fpgrowth;
+        fpgrowth.verbose = verbose ;
+        fpgrowth( init, isfreq, distribth, distribbdP, distribbdN);
+    }
+    else if( useEclat )
+    {
+        // Use Eclat algorithm, with the same parameters as Apriori
+        Eclat<int,Support > eclat;
+        eclat.verbose = verbose ;
+        eclat( init, isfreq, distribth, distribbdP, distribbdN);
+    }
+    else if( !useAbs )
     {
     
         // Use Apriori algorithm with 
@@ -172,6 +218,7 @@ else
         //         Support: to save the cardinality of the projection processed
         Apriori<int,Support > apriori;
         apriori.verbose = verbose ; // To print screen informations about the exectution
+        isfreq.reduce = reduce ; // delete the items and the transactions useless for the next levels (only valid with Apriori)
         apriori( init, isfreq, distribth, distribbdP, distribbdN); // exectue Apriori algorithm to find the boders
          
     }
@@ -181,6 +228,7 @@ else
         // To use ABS do:
         Abs<int,Support> abs;
         abs.verbose = verbose ;
+        abs.mmcs = mmcs ; // compute the first minimal transversals with MMCS instead of the trie
         StopIteDistrib stopApriori(6) ;  // to stop the levelwise exploration at the 2th iteration
         abs( init, isfreq, &stopApriori, distribbdP, distribbdN);
     }
@@ -8,9 +8,10 @@ using namespace std;
 #include "Support.hpp"
 
 #include "SatisfiedIND.hxx"
-#include "Not_predicate.hxx"
+#include "Not_Predicate.hxx"
 
 #include "InitIND.hxx"
+#include "InitIND_Index.hxx"
 
 #include "RecordDistribution.hxx"
 
@@ -30,6 +31,9 @@ using namespace std;
 int main(int argc, char *argv[])
 {
 
+// option -index: find the satisfied unary IND with an inverted index (see InitIND_Index)
+bool useIndex = argc > 1 && strcmp( argv[ 1 ], "-index" ) == 0 ;
+
 //******************************************************************************
 // Define the name and format of the file containing the relational database 
 //******************************************************************************
@@ -80,6 +84,10 @@ Not_Predicate< INDPred > notadi( isadi ) ;
 // These attributes will be used to initialize the exploration of the algorithm
 InitIND<RelationFile > init(r1,r2 );
 
+// This functor inserts only the satisfied unary IND, found in one scan of the relations (they are not tested again by the predicate)
+// The unary IND not satisfied must be added to the negative border (init.listNotSatisfied)
+InitIND_Index< vector< vector<int> >, RelationFile, INDPred > initIndex( relation1, r1, relation2, r2, isadi );
+
 
 //******************************************************************************
 // Define the outputs
@@ -105,7 +113,13 @@ Ens ens;
 // doing a bottom up exploration
 Apriori<UnaryIND> apriori; // Declare algorith Apriori with 
 apriori.verbose = true ;  // To print screen informations about the exectution
-apriori( init, isadi, none, &distribbdP, &distribbdN, ens ); 
+if( useIndex )
+{
+    apriori( initIndex, isadi, none, &distribbdP, &distribbdN, ens ); 
+    initIndex.outputNotSatisfied( &distribbdN ) ; // the unary IND not satisfied are not candidates of Apriori
+}
+else
+    apriori( init, isadi, none, &distribbdP, &distribbdN, ens ); 
 
 
 // exectue Apriori algorithm to find the boders
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <time.h>
+
+using namespace std;
+
+#include "CsvDB.hpp"
+
+#include "Support.hpp"
+
+#include "SatisfiedIND_DBMS.hxx"
+#include "InitIND_DBMS.hxx"
+
+#include "RecordDistribution.hxx"
+
+#include "Ens.hpp"
+
+#include "Apriori.hxx"
+
+//******************************************************************************
+// Example of main program for the discovery of the borders of the
+// the satisfied IND between two relations of a DBMS using algorithm Apriori
+//
+// options:
+//   -batch n : the candidates are tested by queries of n candidates
+//   -bulk : the relations are read once and the candidates are tested in memory
+//******************************************************************************
+
+int main(int argc, char *argv[])
+{
+
+int batchSize = 1 ;
+bool bulk = false ;
+
+for( int i = 1 ; i < argc ; i++ )
+{
+     if( strcmp( argv[ i ], "-batch" ) == 0 && i + 1 < argc )
+         batchSize = atoi( argv[ ++i ] ) ;
+     else if( strcmp( argv[ i ], "-bulk" ) == 0 )
+         bulk = true ;
+}
+
+
+//******************************************************************************
+// Define the database and the relations
+//******************************************************************************
+
+// The relations are stored in csv files and the queries are processed by Csv_db.
+// To use a MySQL database, use Mysql_db (see Mysql.hpp) with the names of the tables:
+// Mysql_db db( "localhost", "database", "login", "password" );
+typedef Csv_db DBMS ;
+
+DBMS db ;
+
+db.select_relation( "bda1.csv" ); // the first relation (left side of the IND)
+db.select_relation( "bda2.csv" ); // the second relation (right side of the IND)
+
+
+//******************************************************************************
+// Define the predicate
+//******************************************************************************
+
+// each test of a candidate is done by a query on the DBMS
+SatisfiedIND_DBMS< DBMS > isadi( &db );
+
+// test the candidates of a level by queries of batchSize candidates
+isadi.batchSize = batchSize ;
+
+// or read the relations once and test the candidates in memory
+if( bulk && ! isadi.readRelations() )
+    cerr<<"The relations cannot be read, the candidates are tested by queries"<<endl;
+
+
+//******************************************************************************
+// Define the initialization function for the algorithm
+//******************************************************************************
+
+// The functor will search the attributes of the relations in the DBMS.
+// These attributes will be used to initialize the exploration of the algorithm
+InitIND_DBMS< DBMS > init( &db );
+
+
+//******************************************************************************
+// Define the outputs
+//******************************************************************************
+
+// save the borders in memory in a vector
+vector< IND >  bdP;
+vector< IND >  bdN;
+
+// Use the class RecordDistribution to save the distribution of Bd- and Bd+
+RecordDistribution<vector< IND > >  distribbdN( & bdN );
+RecordDistribution<vector< IND > >  distribbdP( &bdP);
+
+
+//******************************************************************************
+// Use an algorithm
+//******************************************************************************
+
+// function used to transform IND in sets
+Ens ens;
+
+// exectue Apriori algorithm to find the boders
+// doing a bottom up exploration
+Apriori<UnaryIND> apriori;
+apriori.verbose = true ;  // To print screen informations about the exectution
+apriori( init, isadi, none, &distribbdP, &distribbdN, ens );
+
+
+// print to screen the number of queries
+cout<<"Number of queries: "<<db.nbQueries<<endl;
+
+// print to screen the distribution of Bd-
+cout<<"Distrib bd-"<<endl;
+cout<<distribbdN<<endl;
+
+// print to screen the distribution of Bd-
+cout<<"Distrib bd+"<<endl;
+cout<<distribbdP<<endl;
+
+
+// print bd+
+cout<<"bd+"<<endl;
+for_each( bdP.begin(), bdP.end(), printContainer() ) ;
+
+// print bd-
+cout<<"bd-"<<endl;
+for_each( bdN.begin(), bdN.end(), printContainer() ) ;
+
+
+return 0;
+}
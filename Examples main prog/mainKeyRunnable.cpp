@@ -9,6 +9,7 @@ using namespace std;
 #include "Support.hpp"
 
 #include "Key_base.hxx"
+#include "Key_partition.hxx"
 #include "Not_Predicate.hxx"
 
 #include "InitKey.hxx"
@@ -27,6 +28,88 @@ using namespace std;
 // the super key in a relation using algorithms Apriori or ABS
 //******************************************************************************
 
+
+//******************************************************************************
+// Execute the algorithm chosen with the predicate "being a super key"
+//******************************************************************************
+
+template< class KeyPred, class Init, class Output >
+void findBorders( KeyPred & key, Init & init, Output * distribth, Output * distribbdP, Output * distribbdN, bool use_apriori, bool reverse, bool notpred, int levl, bool mmcs, bool verbose )
+{
+    // invert the predicate
+    // if we want to do a bottom up exploration of the search space
+    // (since the predicate is monotone)
+    Not_Predicate< KeyPred > notkey( key ) ; 
+
+    if( use_apriori )
+    {
+
+        if ( !reverse )        
+        {
+            // Declare algorith Apriori with 
+            //         string: the type of the attributes
+            Apriori<string> apriori;
+            
+            // To print screen informations about the exectution
+            apriori.verbose = verbose ;
+            
+            if( notpred )
+                    // Use Apriori algorithm to find the boders doing a  bottom up exploration
+                    //         string: the type of the attributes
+                    apriori( init, notkey, distribth, distribbdP, distribbdN);
+            else
+                    apriori( init, key, distribth, distribbdP, distribbdN);
+        }
+        else
+        {
+            // Use Apriori algorithm to find the boders doing a  top down exploration
+            //         string: the type of the attributes
+            AprioriReverse<string > apriorirev;
+            apriorirev.verbose = verbose ; // To print screen informations about the exectution
+            if( notpred )            
+                apriorirev( init, notkey, distribth, distribbdP, distribbdN);
+            else
+                apriorirev( init, key, distribth, distribbdP, distribbdN);
+
+            
+        }
+    }
+    else 
+    {
+
+        StopIteDistrib stopApriori(levl) ;  // to stop the levelwise exploration at the levl-th iteration
+            
+        if ( !reverse )        
+        {
+            // To use ABS doing  a bottom up exploration
+            Abs<string> abs;
+            abs.verbose = verbose ;
+            abs.mmcs = mmcs ; // compute the first minimal transversals with MMCS instead of the trie
+            
+            if( notpred )
+                abs( init, notkey, &stopApriori, distribbdP, distribbdN);
+            else
+                abs( init, key, &stopApriori, distribbdP, distribbdN);
+        }
+        else
+        {
+            // To use ABS doing  a top down exploration
+            AbsReverse<string> absrev;
+            absrev.verbose = verbose ;
+            absrev.mmcs = mmcs ;
+            
+            if( notpred )
+                absrev( init, notkey, &stopApriori, distribbdP, distribbdN);
+            else
+                absrev( init, key, &stopApriori, distribbdP, distribbdN);
+                
+
+        }
+        
+    } 
+}
+
+
 int main(int argc, char *argv[])
 {
     
@@ -34,8 +117,10 @@ if(argc < 3) {
     cerr << "usage: " << argv[0] << " datafile " << endl;
     cerr << "\t -apriori          : use apriori algorithm (default)"<< endl;    
     cerr << "\t -abs k            : use abs algorithm and the first dualization is at level \"k\" "<< endl;        
+    cerr << "\t -mmcs             : compute the minimal transversals with MMCS in abs"<< endl;        
     cerr << "\t -reverse          : use a reverse algorithm"<< endl;        
     cerr << "\t -notpred          : use the inverse predicate"<< endl;    
+    cerr << "\t -partition        : use the predicate based on stripped partitions (faster)"<< endl;    
     cerr << "\t -v                : print to screen"<< endl;
     cerr << "\t -th file_name     : save the theory in \"file_name\" "<< endl;
     cerr << "\t -bdp file_name    : save the positive border in \"file_name\" "<< endl;
@@ -48,6 +133,8 @@ else
     bool use_apriori = true ;
     bool notpred = false ;
     bool reverse = false ;
+    bool partition = false ;
+    bool mmcs = false ;
     int levl = 2 ; // level of the first dualization for abs
     char * bdpfile = 0 ;
     char * bdnfile = 0 ;
@@ -90,6 +177,14 @@ else
           else if( strcmp( argv[ i ], "-notpred") == 0 )
           {
                notpred =true ;                          
+           }  
+          else if( strcmp( argv[ i ], "-mmcs") == 0 )
+          {
+               mmcs =true ;                          
+           }  
+          else if( strcmp( argv[ i ], "-partition") == 0 )
+          {
+               partition =true ;                          
            }                     	               	            
                      
           i++ ;             
@@ -113,22 +208,6 @@ else
     vector< vector<int> > relation;
     dbr >> relation;
        
-    //******************************************************************************
-    // Define the predicate 
-    //******************************************************************************
-    
-    // Use the following class to use a basic implementation of the predicate "being a super key"
-     typedef Key_base< vector< vector<int> >, string  > KeyPred;
-     
-    // initialize the predicate
-    KeyPred key(  relation, dbr );
-    
-    // invert the predicate
-    // if we want to do a bottom up exploration of the search space
-    // (since the predicate is monotone)
-    Not_Predicate< KeyPred > notkey( key ) ; 
-
-
     //******************************************************************************
     // Define the initialization function for the algorithm 
     //******************************************************************************
@@ -166,74 +245,21 @@ else
     
     
     //******************************************************************************
-    // Use an algorithm
+    // Define the predicate and use an algorithm
     //******************************************************************************
     
-    
-    if( use_apriori )
+    if( partition )
     {
-
-        if ( !reverse )        
-        {
-            // Declare algorith Apriori with 
-            //         string: the type of the attributes
-            Apriori<string> apriori;
-            
-            // To print screen informations about the exectution
-            apriori.verbose = verbose ;
-            
-            if( notpred )
-                    // Use Apriori algorithm to find the boders doing a  bottom up exploration
-                    //         string: the type of the attributes
-                    apriori( init, notkey, &distribth, &distribbdP, &distribbdN);
-            else
-                    apriori( init, key, &distribth, &distribbdP, &distribbdN);
-        }
-        else
-        {
-            // Use Apriori algorithm to find the boders doing a  top down exploration
-            //         string: the type of the attributes
-            AprioriReverse<string > apriorirev;
-            apriorirev.verbose = verbose ; // To print screen informations about the exectution
-            if( notpred )            
-                apriorirev( init, notkey, &distribth, &distribbdP, &distribbdN);
-            else
-                apriorirev( init, key, &distribth, &distribbdP, &distribbdN);
-
-            
-        }
+        // Use the following class to use an implementation of the predicate based on stripped partitions (faster)
+        Key_partition< vector< vector<int> >, string  > key(  relation, dbr );
+        findBorders( key, init, &distribth, &distribbdP, &distribbdN, use_apriori, reverse, notpred, levl, mmcs, verbose ) ;
     }
-    else 
+    else
     {
-
-        StopIteDistrib stopApriori(levl) ;  // to stop the levelwise exploration at the levl-th iteration
-            
-        if ( !reverse )        
-        {
-            // To use ABS doing  a bottom up exploration
-            Abs<string> abs;
-            abs.verbose = verbose ;
-            
-            if( notpred )
-                abs( init, notkey, &stopApriori,&distribbdP, &distribbdN);
-            else
-                abs( init, key, &stopApriori, &distribbdP, &distribbdN);
-        }
-        else
-        {
-            // To use ABS doing  a top down exploration
-            AbsReverse<string> absrev;
-            absrev.verbose = verbose ;
-            
-            if( notpred )
-                absrev( init, notkey, &stopApriori, &distribbdP, &distribbdN);
-            else
-                absrev( init, key, &stopApriori, &distribbdP, &distribbdN);
-                
-
-        }
-        
-    } 
+        // Use the following class to use a basic implementation of the predicate "being a super key"
+        Key_base< vector< vector<int> >, string  > key(  relation, dbr );
+        findBorders( key, init, &distribth, &distribbdP, &distribbdN, use_apriori, reverse, notpred, levl, mmcs, verbose ) ;
+    }
     
     // print to screen the distribution of Bd- 
     cout<<"Theory distribution"<<endl;
@@ -24,6 +24,7 @@
 #include <set>
 
 #include "Apriori.hxx"
+#include "MinTransversals.hxx"
 #include "NoOutput.hxx"
 
 
@@ -196,8 +197,6 @@ class Abs
     	    \param inbdp the positive border (all the elements of Bd+ found until the current iteration) 
         */
     	void genCand( PTree< SetsType, Measure > * subSet, PTree< SetsType, Measure > * inbdp ) ;
-        	
-    	bool genCand( Node< SetsType, Measure > * subSet, Node< SetsType, Measure > * bdp, PTree< SetsType, Measure > * tr, int & pos ) ;
     	    	
         //! Method used to do the optimist approach based on "almost interesting" elements
         /**   
@@ -264,14 +263,32 @@ class Abs
         //! Boolean to print to screen some informations during the execution (default false)
         bool verbose;         	    	           
 	
+        //! Boolean to compute the minimal transversals of the negative border found by Apriori with MinTransversals (default false)
+        /**
+            The minimal transversals are enumerated with the algorithm MMCS on bitsets, instead of PTree::trMinOpt.
+            The next dualizations are always done incrementally (PTree::trMinIopt).
+        */
+        bool mmcs ;
+        
+        //! Number of threads used by MinTransversals (1 by default, ie no thread)
+        int nbTransversalThreads ;
 
     public:
     
     	//! Constructor.  
-    	Abs(){ bdN = new Cand_DataStruct; bdP = new Cand_DataStruct; verbose=false;  } //bdPapriori = new Cand_DataStruct ;	bdNapriori = new Cand_DataStruct}
+    	Abs(){ bdN = new Cand_DataStruct; bdP = new Cand_DataStruct; verbose=false; mmcs = false; nbTransversalThreads = 1; } //bdPapriori = new Cand_DataStruct ;	bdNapriori = new Cand_DataStruct}
     
     	//! Destructor.
     	~Abs(){ verbose= false; if( bdP ) delete bdP; if( bdN ) delete bdN; } //if( bdPapriori ) delete bdPapriori; if( bdNapriori ) delete bdNapriori; }
+
+        //! Set the recode functor used to encode the candidates and the borders.
+        /**
+            By default, the recode functor of the current thread is used.
+            Set a different one to execute several algorithms at the same time in a thread
+            (the recode functor must be shared with the tries used as outputs).
+            \param inRecode the recode functor
+        */
+        void setRecode( RecodeToInt<SetsType> * inRecode ) { apriori.setRecode( inRecode ) ; bdN->setRecode( inRecode ) ; bdP->setRecode( inRecode ) ; }
 	
         //! Functor operator that executes the algorithm.
         /**
@@ -329,7 +346,7 @@ void Abs< SetsType, Measure,  Cand_DataStruct >::executeAlgorithm( InitFunctor &
          
     PTree< SetsType, Measure > * complSet = 0 ;
 
-	PTree< SetsType, Measure > * opt=  new PTree< SetsType, Measure >( 0 );	// store all the itemsets that are closed to the positive border
+	PTree< SetsType, Measure > * opt=  new PTree< SetsType, Measure >( 0, 0, 0, bdN->recode );	// store all the itemsets that are closed to the positive border
 
 	PTree< SetsType, Measure > * transv = 0 ;
 
@@ -372,13 +389,21 @@ void Abs< SetsType, Measure,  Cand_DataStruct >::executeAlgorithm( InitFunctor &
 		// Calculation of the transversals mins
 		// from the part of the negative border found using Apriori
 
-		freqTr = new PTree< SetsType, Measure >( 0 ) ;
+		freqTr = new PTree< SetsType, Measure >( 0, 0, 0, bdN->recode ) ;
 
 		time( &start );
 
         // Minimal transversal computation to construct the optimistic positive border
-		transv = bdN->trMinOpt( 2 , nbfitem - dualizelevel ) ; // only sets of size > 2 are considered for the transversal minimal computation
-		                                                       // since not interesting items (ie those of size 1) are not considered during the exploration		                                                       
+		// only sets of size > 2 are considered for the transversal minimal computation
+		// since not interesting items (ie those of size 1) are not considered during the exploration		                                                       
+		if( mmcs )
+		{
+		    MinTransversals< SetsType, Measure > minTransversals ;
+		    minTransversals.nbThreads = nbTransversalThreads ;
+		    transv = minTransversals( *bdN, 2 , nbfitem - dualizelevel ) ; 
+		}
+		else
+		    transv = bdN->trMinOpt( 2 , nbfitem - dualizelevel ) ; 
         
         time( &end) ;
            
@@ -404,7 +429,7 @@ void Abs< SetsType, Measure,  Cand_DataStruct >::executeAlgorithm( InitFunctor &
 				complSet = transv->complem( listInterestItems ) ;
 			else // no itemsets are generated in the optimistic positive border  ->  test the longest itemset
 			{
-                complSet =  new PTree< SetsType, Measure >( ) ;
+                complSet =  new PTree< SetsType, Measure >( 0, 0, 0, bdN->recode ) ;
 			    complSet->push_back( listInterestItems );
              }
 
@@ -430,7 +455,7 @@ void Abs< SetsType, Measure,  Cand_DataStruct >::executeAlgorithm( InitFunctor &
 			totGen = complSet->size() ;
 
 			time( &start );
-			trie = new PTree< SetsType, Measure >( ) ;
+			trie = new PTree< SetsType, Measure >( 0, 0, 0, bdN->recode ) ;
 
 			nbFreq = processOptGenSub( pred, complSet, opt, transv, freqTr, trie, dualizelevel+1, wordToSet, error  ) ;
 
@@ -616,7 +641,7 @@ int Abs< SetsType, Measure, Cand_DataStruct >::processOptGenSub(  Predicate  * p
 	tmp = new vectUI ;
     
     if( ! this->bdP )
-        bdP = new PTree< SetsType, Measure >();
+        bdP = new PTree< SetsType, Measure >( 0, 0, 0, bdN->recode );
 
 	nbFreq = bdP->size() + opt->size() ;
 
@@ -654,7 +679,7 @@ bool Abs< SetsType, Measure, Cand_DataStruct >::processOptGenSub(  Predicate * p
                              || ! (* currNode->getChilds() )[ i ] )
             {   
 
-                ItCand it( currNode, i+currNode->getOffset(), &complSet->recode,  itemset->size() );      
+                ItCand it( currNode, i+currNode->getOffset(), complSet->recode,  itemset->size() );      
 
     			if( !(*pred)( wordToSet.inverse(it), it.measure() ) ) 
     			{                    
@@ -749,7 +774,7 @@ void Abs< SetsType, Measure,  Cand_DataStruct >::moveTransFreq( vectUI *itemset,
 	// we search the transversal associated with this itemset
 
 
-	comp = tr->getHead()->complem( itemset, tr->recode( listInterestItems) );
+	comp = tr->getHead()->complem( itemset, (*tr->recode)( listInterestItems) );
 
     if( comp && comp->size() )
     {
@@ -818,7 +843,7 @@ int Abs< SetsType, Measure, Cand_DataStruct >::pruneCandidates( Predicate  * pre
 
         if(depth == level)
         {          
-              ItCand it( currNode, (*itemset)[depth-1] , &bdP->recode , level ) ;  
+              ItCand it( currNode, (*itemset)[depth-1] , bdP->recode , level ) ;  
 
               if( ! (*pred)(  wordToSet.inverse(it), it.measure() ) ) 
               {                 
@@ -871,118 +896,23 @@ int Abs< SetsType, Measure, Cand_DataStruct >::pruneCandidates( Predicate  * pre
 template< class SetsType, class Measure,  class Cand_DataStruct >
 void Abs< SetsType, Measure,Cand_DataStruct >::genCand( PTree< SetsType, Measure > * subSet, PTree< SetsType, Measure > * inbdp )
 {
-	bool del = false ;
-
-	setPTreeIt tmpIt ;
-
-	if( subSet != 0 && inbdp != 0 && subSet->getHead() )
+	if( subSet != 0 && inbdp != 0 && subSet->getHead() && inbdp->getHead() )
 	{
-		for( int i = 0; i < subSet->getHead()->getCnts()->size() ; i++ )
-		{
-	
-			if( subSet->getHead()->existVal( i ) )
-			{
-    	        del=genCand( subSet->getHead() , inbdp->getHead(), subSet, i ) ; 
-
-    			if( del && ! subSet->getHead()->getCnts() )
-    			{
-                           delete subSet->getHead() ;
-                           
-                           subSet->setHead( 0 ) ;
-                           break;
-                }    
-    		}
-  		}
-  		  		
-	}
-}
-
-template< class SetsType, class Measure,  class Cand_DataStruct >
-bool Abs< SetsType, Measure, Cand_DataStruct >::genCand( Node< SetsType, Measure > * subSet, Node< SetsType, Measure > * bdp, PTree< SetsType, Measure > * tr, int & pos )
-{
-    
-   	bool del = false ;
-
-   	int index ;
-   	
-	if( subSet == 0 || bdp == 0 ) return del;
+	    // the inclusion tests are done with an index of Bd+ (instead of exploring Bd+ for each subset)
+	    SetIndex< SetsType, Measure > index( *inbdp ) ;
 
+	    index.eraseIncluded( *subSet ) ;
 
-    index = pos + subSet->getOffset() - bdp->getOffset() ;
-
-
-    if( index >= 0  ) // is index < 0 the current item in subset can't be in bdp
-	{
-
-	    if( index < bdp->getCnts()->size() &&  bdp->existVal( index ) ) // the item is in bdp
+	    if( subSet->getHead() && ! subSet->getHead()->getCnts() )
 	    {
-        
-        	if( ! subSet->getChilds() || pos >= subSet->getChilds()->size() || ! (* subSet->getChilds() )[ pos ] ) 
-    		{
+	        delete subSet->getHead() ;
 
-    			del = true ;
-                if( mem > 0 )
-                 subSet->setCnt( pos, 0 ) ;
-                else
-                                 pos = subSet->deleteItVect( pos )  ;  
-    			
-    			tr->Decrement() ;
-    
-       		}
-    		else // we don't have reached an itemset of subset
-          	{    
-
-          	   if(  bdp->getChilds() && index < bdp->getChilds()->size() 
-                                && (* bdp->getChilds() )[ index ] )
-               {
-
-                    Node< SetsType, Measure > * child = (* subSet->getChilds() )[ pos ] ;  
-
-                	for( int i = 0 ; i < child->getCnts()->size() ; i++ )
-                	{       
-
-                	    if( child->existVal( i )  )
-                	    {                                         	        
-                	       del = genCand(  child, ( * bdp->getChilds() )[ index ], tr, i );
-                     	                            	  
-                	    }  
-
-                         if( del && ! child->getCnts() )
-                	    {
-                            if( mem > 0 )
-                             subSet->setCnt( pos, 0 ) ;
-                            else
-                             pos = subSet->deleteItVect( pos )  ;  
-                               
-                            return del;
-                        }    
-                	}                                                                                   
-           	    }          	    
-          	} 
-        }
-        
-
-        if(  subSet->getCnts() )
-        {
-            if( bdp->getChilds() )
-            {
-                for( int j = 0 ;  j < index &&  j < bdp->getChilds()->size() && !( del && 
-                    	( ! subSet->getCnts() || pos >= subSet->getCnts()->size()
-                         || ! subSet->existVal( pos )  ) ) 			          	    
-                 ; j++ )
-                 {
-
-                     if(  (* bdp->getChilds() )[ j ] )        
-                          del = genCand(  subSet, (* bdp->getChilds() )[ j ], tr, pos  );
-
-                 }    
-            }           
-        }    
-    }          			      		    
-			
-    return del;
+	        subSet->setHead( 0 ) ;
+	    }
+	}
 }
 
+
 // ----------------------------------------------------------------------------------------------       
         	    
 //! Method used to do the optimist approach based on "almost interesting" elements
@@ -1006,7 +936,7 @@ void Abs< SetsType, Measure, Cand_DataStruct >::optApproach( Predicate  * pred,
 
 	setPTreeIt tmp ;
 	
-	PTree< SetsType, Measure > tmpSet(0) ;
+	PTree< SetsType, Measure > tmpSet( 0, 0, 0, bdN->recode ) ;
 
 	int nbfreq ;
 	
@@ -1234,10 +1164,10 @@ void Abs< SetsType, Measure, Cand_DataStruct >::initOptApproach( Node< SetsType,
                 else	// we have check all the items of the current itemset strored in vect			
        			{       // construction of the trees that regroup itemsets wrt their size
             	
-            		tmp = optIt->find( PTree< SetsType, Measure >( 0,0, itemset->size() ) );
+            		tmp = optIt->find( PTree< SetsType, Measure >( 0,0, itemset->size(), bdN->recode ) );
             
             		if( tmp == optIt->end() )         		        
-            				tmp = optIt->insert( PTree< SetsType, Measure >(0,0, itemset->size() ) ).first ;
+            				tmp = optIt->insert( PTree< SetsType, Measure >(0,0, itemset->size(), bdN->recode ) ).first ;
            
             		// the itemsets for the optimist approach
             		// are inserted into the good PTree< SetsType, Measure > of optIt
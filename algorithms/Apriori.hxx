@@ -27,8 +27,14 @@
 #include "Complement.hxx"
 #include "Boolean.hpp"
 #include "PTree.hxx"
+#include "FlatPTree.hxx"
+#include "SubsetHash.hxx"
  
  #include <deque>
+ #include <thread>
+ #include <atomic>
+ #include <algorithm>
+ #include <numeric>
 
 //! Functor finding the theory and/or the negative border and/or the positive border using the algorithm Apriori.
 /**
@@ -137,6 +143,111 @@ class Apriori
         template< class Iterator >
         bool testSubset( Iterator & itPref, Iterator & itLast, vector<SetsType> & buffer ) ;
         
+        //! Functor executed by each generation thread
+        /**
+            The leaves are shared in blocks of consecutive leaves (ie of leaves with close prefixes).
+            The threads take the next block not already processed until there is no more block,
+            and store for each block the candidates found (index of the leaf and element to add).
+            The candidates are only searched, the trie is not modified.
+        */
+        template< class Iterator >
+        class generationThread
+        {
+                Apriori * algo ;
+                
+                //! leaves of the current level
+                vector< Iterator > * leaves ;
+                
+                //! candidates found in each block
+                vector< vector< pair< int, SetsType > > > * results ;
+                
+                //! number of leaves of a block
+                int blockSize ;
+                
+                //! next block to process
+                atomic<int> * next ;
+                
+                int level ;
+                
+            public:
+                
+                generationThread( Apriori * inalgo, vector< Iterator > * inleaves, vector< vector< pair< int, SetsType > > > * inresults, int inblockSize, atomic<int> * innext, int inlevel )
+                {
+                    algo = inalgo ; leaves = inleaves ; results = inresults ; blockSize = inblockSize ; next = innext ; level = inlevel ;
+                }
+                
+                void operator()()
+                {
+                     vector<SetsType> buffer ;     // buffer used to find subsets
+                     buffer.reserve( level +1 ) ;
+                     
+                     int block ;
+                     while( ( block = next->fetch_add( 1 ) ) < (int) results->size() )
+                     {
+                          int last = ( block + 1 ) * blockSize < (int) leaves->size() ? ( block + 1 ) * blockSize : leaves->size() ;
+                          
+                          for( int l = block * blockSize ; l < last ; l++ )
+                          {
+                               Iterator itLeaf = (*leaves)[ l ] ;
+                               
+                               for( Iterator itCand = itLeaf.nextChildNode() ; itCand != Iterator() ; itCand = itCand.nextChildNode() )
+                                    if( algo->testSubset( itLeaf, itCand, buffer ) )
+                                        (*results)[ block ].push_back( make_pair( l, itCand.element() ) ) ;
+                          }
+                     }
+                }
+        };
+        
+        //! Functor executed by each thread testing the candidates wrt the predicate
+        /**
+            The candidates are shared in blocks of consecutive candidates,
+            the threads take the next block not already processed until there is no more block.
+            The result of the predicate is only stored for each candidate, the trie is not modified.
+            Each thread has its own copy of wordToSet (the transformation may use a buffer).
+        */
+        template< class Predicate, class f >
+        class predicateThread
+        {
+                Predicate * pred ;
+                
+                //! copy of the transformation of the sets in words used by the thread
+                f wordToSet ;
+                
+                //! candidates to test
+                vector< typename Cand_DataStruct::iterator > * cands ;
+                
+                //! result of the predicate for each candidate
+                vector< char > * results ;
+                
+                //! number of candidates of a block
+                int blockSize ;
+                
+                //! next block to process
+                atomic<int> * next ;
+                
+            public:
+                
+                predicateThread( Predicate * inpred, f & inwordToSet, vector< typename Cand_DataStruct::iterator > * incands, vector< char > * inresults, int inblockSize, atomic<int> * innext )
+                    : wordToSet( inwordToSet )
+                {
+                    pred = inpred ; cands = incands ; results = inresults ; blockSize = inblockSize ; next = innext ;
+                }
+                
+                void operator()()
+                {
+                     int nbBlocks = ( cands->size() + blockSize - 1 ) / blockSize ;
+                     
+                     int block ;
+                     while( ( block = next->fetch_add( 1 ) ) < nbBlocks )
+                     {
+                          int last = ( block + 1 ) * blockSize < (int) cands->size() ? ( block + 1 ) * blockSize : cands->size() ;
+                          
+                          for( int c = block * blockSize ; c < last ; c++ )
+                               (*results)[ c ] = (*pred)( wordToSet.inverse( (*cands)[ c ] ), (*cands)[ c ].measure() ) ;
+                     }
+                }
+        };
+        
         //! Erase all the k-1 subsets of the set of size k coresponding to the iterator in parameter.
         /**   
            \param cand contains the theory.
@@ -159,11 +270,61 @@ class Apriori
         
         //! Boolean to save the set representation of the solution
         bool saveSet;
+        
+        //! Boolean to explore the candidates during the generation with a flat copy of the candidates (default false)
+        bool flat;
+        
+        //! Number of threads used to generate the candidates (1 by default, ie no thread)
+        int nbThreads;
+        
+        //! Boolean to test the subsets of the candidates with a hash index of the sets of the precedent level (default false)
+        /**
+            The index is filled when the sets are tested wrt the predicate, and it is cleared after the generation of the candidates.
+            If the internal ids of the sets do not fit in a key of 64 bits, the subsets are searched in the trie.
+        */
+        bool hashSubsets;
+        
+        //! Number of threads used to test the candidates wrt the predicate (1 by default, ie no thread)
+        /**
+            The predicate is called by several threads at the same time, so it must not modify shared data
+            (it is the case of Key_base and SatisfiedIND, but not of Frequent which updates the recoding of the items).
+            The outputs and the pruning of the candidates stay in the same order than with one thread.
+        */
+        int nbPredicateThreads;
+        
+        //! Memory budget of the candidates in bytes (0 by default, ie no budget)
+        /**
+            If the memory of the trie (the memory used in the arena) and of the candidates of a level may exceed the budget,
+            the candidates are generated, counted and tested in batches of consecutive leaves (see batchesGeneration()).
+            The batches are explored directly in the trie (not in a flat copy), and the hash index of the subsets of the level is used by all the batches.
+            If the trie alone nearly fills the budget, or if the budget would need more than maxBatches batches, a warning is printed
+            and the batches exceed the budget (see batchesGeneration()).
+        */
+        long memoryBudget;
+
+        //! Maximal number of batches of a level (about), when the candidates are processed by batches (8 by default)
+        /**
+            Each batch reads the data (for Frequent), so a batch contains at least the candidates of the leaves
+            using the maxBatches-th of the memory estimated for the level, even if the budget is exceeded.
+        */
+        int maxBatches;
             
     protected:
         
+        //! Arena where the nodes of the candidates are allocated (released at once at the end)
+        NodeArena arena ;
+        
         //! The candidates generated.        
         Cand_DataStruct candidates ;
+        
+        //! Hash index of the sets of the last level tested (used if hashSubsets is true)
+        SubsetHash subsetHash ;
+        
+        //! Hash index of the sets of the level tested by batches (subsetHash is used to generate the next batches)
+        SubsetHash nextSubsetHash ;
+
+        //! True if the warning of the memory budget has been printed (it is printed once by execution)
+        bool budgetExceeded ;
                
 
     protected:
@@ -175,6 +336,85 @@ class Apriori
            \return the number of sets generated.
         */     
         int candidatesGeneration( Cand_DataStruct & cand , int &level);      
+
+        //! Candidate generation phase of Apriori, exploring the leaves with a given iterator.
+        /**
+           The iterators can be on the candidates or on a flat copy of the candidates.
+           \param cand set of candidates.
+           \param level current size of the candidates
+           \param itLeaf iterator on the first leaf
+           \param end end iterator
+           \return the number of sets generated.
+        */     
+        template< class Iterator >
+        int candidatesGeneration( Cand_DataStruct & cand , int &level, Iterator itLeaf, Iterator end );      
+
+        //! Candidate generation phase of Apriori with several threads.
+        /**
+           The candidates are searched by nbThreads threads without modifying the trie,
+           and then inserted in the trie in the same order than candidatesGeneration(), so the trie obtained is the same.
+           \param cand set of candidates.
+           \param level current size of the candidates
+           \param itLeaf iterator on the first leaf
+           \param end end iterator
+           \return the number of sets generated.
+        */     
+        template< class Iterator >
+        int candidatesGenerationParallel( Cand_DataStruct & cand , int &level, Iterator itLeaf, Iterator end );      
+
+        //! Estimate the memory of the candidates generated with each leaf of the current level (upper bound).
+        /**
+           The leaves of a node are consecutive, and a leaf generates at most one candidate with each following leaf of its node,
+           stored in a new child node.
+           The memory is counted as in the arena (blocks with a header and rounded), and the vectors are supposed to be twice bigger than needed (their growth by resize).
+           The total also contains the memory of a leaf, since the biggest vector can be reallocated while the old one is not released yet.
+           \param cand set of candidates.
+           \param level current size of the candidates
+           \param leaves the leaves of the current level (in the order of the exploration)
+           \param memory the memory (in bytes) of the candidates of each leaf
+           \return the memory of all the candidates.
+        */     
+        long candidatesMemory( Cand_DataStruct & cand , int level, vector< typename Cand_DataStruct::iterator > & leaves, vector< long > & memory );      
+
+        //! Estimate the memory of the vector of the child nodes of a node (upper bound, see candidatesMemory()).
+        long childsMemory( Node< SetsType, Measure > * node )
+        {
+            return NodeArena::blockBytes( sizeof( typename Node< SetsType, Measure >::vectN ) ) 
+                   + NodeArena::blockBytes( 2 * node->getCnts()->size() * sizeof( Node< SetsType, Measure > * ) ) ;
+        }
+
+        //! Generation, count and pruning phases of Apriori for batches of leaves, so that the candidates of a batch fit in the memory budget.
+        /**
+           A batch is composed of consecutive leaves (ie of leaves with close prefixes): the first leaf not processed generating candidates,
+           and the following ones while the memory of their candidates and of the trie is lower than memoryBudget.
+           A batch can use at least the maxBatches-th of the memory of the candidates of the level, so that the data are not read for a few candidates
+           when the trie nearly fills the budget or when the budget is small (the budget is exceeded and a warning is printed once).
+           The candidates of each batch are generated, their support is computed by the predicate (ie a pass on the data for Frequent),
+           and they are tested wrt the predicate, so only the interesting ones are kept before the next batch.
+           \param cand set of candidates.
+           \param level current size of the candidates
+           \param leaves the leaves of the current level (in the order of the exploration)
+           \param memory the memory (in bytes) of the candidates of each leaf
+           \param pred the predicate.
+           \param theory output the theory in the given objet (must have a push_back( container, measure ) method).                      
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).                      
+           \param wordToSet  transform the sets in words of the language studied.
+           \param stopIte functor stop that stop the execution of apriori before the end.
+           \param setToWordSave  transform for output the sets find by the algorithm in words of the language.               
+           \return the number of candidates respecting the predicate.
+        */     
+        template< class Predicate, class OutputTheory, class OutputBdN, class f, class StopIteration, class f2 >
+        int batchesGeneration( Cand_DataStruct & cand , int &level, vector< typename Cand_DataStruct::iterator > & leaves, vector< long > & memory,
+                               Predicate * pred, OutputTheory * theory, OutputBdN * bdN, f & wordToSet, StopIteration * stopIte, f2 & wordToSetSave );      
+
+        //! Return an iterator on the candidates corresponding to a given iterator
+        typename Cand_DataStruct::iterator candIterator( Cand_DataStruct &, typename Cand_DataStruct::iterator & it ){ return it ; }
+
+        //! Return an iterator on the candidates corresponding to an iterator on a flat copy of the candidates
+        typename Cand_DataStruct::iterator candIterator( Cand_DataStruct & cand, ItFlatPTree<SetsType,Measure> & it )
+        { 
+            return typename Cand_DataStruct::iterator( it.source(), it.elementId(), cand.recode, it.length() ) ;
+        }
         
         //! Pruning generation phase of Apriori.
         /**
@@ -184,10 +424,31 @@ class Apriori
            \param theory output the theory in the given objet (must have a push_back( container, measure ) method).                      
            \param setToWordSave  transform for output the sets find by the algorithm in words of the language.               
            \param listInterestItems list of all the interesting items (set representation).             
+           \param skip number of candidates already tested (the first leaves of the last level, tested with a precedent batch).
            \return the number of candidates pruned.
         */
         template<class Predicate, class OutputTheory , class OutputBdN, class f, class f2 >
-        int prune(  Cand_DataStruct & cand,  Predicate * pred,  OutputTheory * theory  , OutputBdN * bdN , f & wordToSet, f2 & wordToSetSave, deque<SetsType> * listInteresItems =0 );     
+        int prune(  Cand_DataStruct & cand,  Predicate * pred,  OutputTheory * theory  , OutputBdN * bdN , f & wordToSet, f2 & wordToSetSave, deque<SetsType> * listInteresItems =0, int skip =0 );     
+
+        //! Test the last candidates generated wrt the predicate with nbPredicateThreads threads.
+        /**
+           \param cand set of candidates.
+           \param pred the predicate.
+           \param wordToSet  transform the sets in words of the language studied.
+           \param results stores the result of the predicate for each candidate (in the order of the leaves).
+           \param skip number of candidates already tested (not tested again).
+        */
+        template<class Predicate, class f >
+        void testCandidates(  Cand_DataStruct & cand,  Predicate * pred, f & wordToSet, vector< char > & results, int skip =0 );     
+
+        //! Output the sets of a trie which are not included in another one of the trie (ie the elements of the positive border).
+        /**
+           \param maximals trie storing the sets without interesting superset among the sets explored.
+           \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+           \param wordToSetSave  transform for output the sets find by the algorithm in words of the language.
+        */
+        template< class OutputBdP, class f2 >
+        void outputMaximals( Cand_DataStruct & maximals, OutputBdP * bdP, f2 & wordToSetSave ) ;
 
     public:
            
@@ -209,10 +470,19 @@ class Apriori
 
            
         //! Constructor           
-        Apriori(){verbose=false;}
+        Apriori(){verbose=false; flat=false; nbThreads=1; nbPredicateThreads=1; hashSubsets=false; memoryBudget=0; maxBatches=8; budgetExceeded=false; candidates.setArena( &arena ) ;}
         
         // ! Destructor
-        ~Apriori(){ } 
+        ~Apriori(){ candidates.release() ; } 
+        
+        //! Set the recode functor used to encode the candidates.
+        /**
+            By default, the recode functor of the current thread is used.
+            Set a different one to execute several algorithms at the same time in a thread
+            (the recode functor must be shared with the tries used as outputs).
+            \param inRecode the recode functor
+        */
+        void setRecode( RecodeToInt<SetsType> * inRecode ) { candidates.setRecode( inRecode ) ; }
         
         //! Functor operator that executes the algorithm.
         /**
@@ -306,6 +576,8 @@ void Apriori<  SetsType,  Measure,  Cand_DataStruct >::executeAlgo( InitFunctor
     bool stop = false ;
     
     startall = clock();  
+    
+    budgetExceeded = false ;
      
      
     int level = 1; // current level of the levelwise exploration of the search space
@@ -356,32 +628,50 @@ void Apriori<  SetsType,  Measure,  Cand_DataStruct >::executeAlgo( InitFunctor
          if( verbose ) cout<<" LEVEL :"<<level+1;   
 
          start = clock();    
+         
+         vector< typename Cand_DataStruct::iterator > leaves ; // leaves of the current level
+         vector< long > memory ; // memory of the candidates of each leaf
                    
-         // Candidate generation using interseting precedent elements
-         nbSet = candidatesGeneration( candidates, level ) ;
+         if( memoryBudget && arena.bytesUsed + candidatesMemory( candidates, level, leaves, memory ) > memoryBudget )
+         {
+            // the candidates may not fit in the memory budget, they are generated, counted and tested by batches
+            nbSet = batchesGeneration( candidates, level, leaves, memory, pred, theory, bdN, wordToSet, stopIte, wordToSetSave ) ;
+            
+            if( verbose ) cout<<" ["<<(clock()-start)/CLOCKS_PER_SEC<<"s] Theory:"<<nbSet;
+         }
+         else
+         {
+            vector< typename Cand_DataStruct::iterator >().swap( leaves ) ;
+            
+            // Candidate generation using interseting precedent elements
+            nbSet = candidatesGeneration( candidates, level ) ;
 
-         if( verbose ) cout<<" Generate ["<<(clock()-start)/CLOCKS_PER_SEC<<"s]  Cand:"<<nbSet;
+            if( verbose ) cout<<" Generate ["<<(clock()-start)/CLOCKS_PER_SEC<<"s]  Cand:"<<nbSet;
     
-         if( candidates.length() == level+1 ) // new candidates have been generated
-         {
-            start = clock();
+            if( candidates.length() == level+1 ) // new candidates have been generated
+            {
+               start = clock();
              
-            // Preprocessing of the candidates
-            pred->preProcessing( candidates, wordToSet );
+               // Preprocessing of the candidates
+               pred->preProcessing( candidates, wordToSet );
             
-            if( verbose ) cout<<" Pre processing ["<<(clock()-start)/CLOCKS_PER_SEC<<"s] ";
+               if( verbose ) cout<<" Pre processing ["<<(clock()-start)/CLOCKS_PER_SEC<<"s] ";
  
-            // update the stop functor with the actual  information about the execution
-            if( stopIte )
-                stopIte->update( candidates ) ;
+               // update the stop functor with the actual  information about the execution
+               if( stopIte )
+                   stopIte->update( candidates ) ;
             
-            start = clock();    
+               start = clock();    
                                  
-            // Test candidates wrt the predicate and "prune"  bad ones (not delete right now but marked as bad ones)         
-            nbSet -= prune( candidates, pred, theory, bdN, wordToSet, wordToSetSave );
+               // Test candidates wrt the predicate and "prune"  bad ones (not delete right now but marked as bad ones)         
+               nbSet -= prune( candidates, pred, theory, bdN, wordToSet, wordToSetSave );
                     
-            if( verbose ) cout<<" Prune ["<<(clock()-start)/CLOCKS_PER_SEC<<"s] Theory:"<<nbSet;
-            
+               if( verbose ) cout<<" Prune ["<<(clock()-start)/CLOCKS_PER_SEC<<"s] Theory:"<<nbSet;
+            }
+         }
+    
+         if( candidates.length() == level+1 ) // new candidates have been generated
+         {
             start = clock(); 
             
             // Postprocessing of the candidates
@@ -407,7 +697,7 @@ void Apriori<  SetsType,  Measure,  Cand_DataStruct >::executeAlgo( InitFunctor
          }
      }   
      
-     if( verbose ){ cout<<endl; cout<<"Totat execution time ["<<(clock()-startall)/CLOCKS_PER_SEC<<"s]"<<endl; cout<<endl;} 
+     if( verbose ){ cout<<endl; arena.printStats( cout ) ; cout<<"Totat execution time ["<<(clock()-startall)/CLOCKS_PER_SEC<<"s]"<<endl; cout<<endl;} 
 }
 
 // ----------------------------------------------------------------------------------------------
@@ -421,26 +711,57 @@ void Apriori<  SetsType,  Measure,  Cand_DataStruct >::executeAlgo( InitFunctor
 template<  class SetsType ,  class Measure,  class Cand_DataStruct  > 
 int Apriori<  SetsType, Measure,   Cand_DataStruct>::candidatesGeneration( Cand_DataStruct & cand, int &level )
 {
+    int nb ;
+    
+    if( flat )
+    {
+        // the new candidates are inserted in the leaves of the trie, the copy of the existing candidates stays valid
+        FlatPTree< SetsType, Measure > flatCand( cand.getHead(), cand.recode ) ;
+        
+        nb = candidatesGeneration( cand, level, flatCand.beginLeaf(), flatCand.end() ) ;
+    }
+    else
+        nb = candidatesGeneration( cand, level, cand.beginLeaf(), cand.end() ) ;
+    
+    subsetHash.clear() ; // the sets of the precedent level are not used anymore
+    
+    return nb ;
+}
+
+//! Candidate generation phase of Apriori, exploring the leaves with a given iterator.
+/**
+   \param cand set of candidates.
+   \param level current size of the candidates.
+   \param itLeaf iterator on the first leaf
+   \param end end iterator
+   \return the number of sets generated.
+*/
+template<  class SetsType ,  class Measure,  class Cand_DataStruct  > template< class Iterator >
+int Apriori<  SetsType, Measure,   Cand_DataStruct>::candidatesGeneration( Cand_DataStruct & cand, int &level, Iterator itLeaf, Iterator end )
+{
+    if( nbThreads > 1 )
+        return candidatesGenerationParallel( cand, level, itLeaf, end ) ;
+    
     SetsType elem  ;  
     int nb =0 ;
 
     vector<SetsType> buffer ;     // buffer used to find subsets
     buffer.reserve( level +1 ) ;  // initialized here to avoid unnecessary memory allocation
     
-    typename Cand_DataStruct::iterator itLeaf = cand.beginLeaf(); // iterator on the leafs of the trie
-    typename Cand_DataStruct::iterator itCand; // iterator on the leaf nodes with the same prefix (the first cand.length()-1 elements are identicals)
+    Iterator itCand; // iterator on the leaf nodes with the same prefix (the first cand.length()-1 elements are identicals)
 
-    while( itLeaf != cand.end() )    // go throw each the leaf and test if we can generate a candidate
+    while( itLeaf != end )    // go throw each the leaf and test if we can generate a candidate
     {
         itCand = itLeaf.nextChildNode(); // get the next  nodes used for a possible candidate generation
 
-        while( itLeaf.length() == level  && itCand !=  typename Cand_DataStruct::iterator()  ) // here the default iterator represent an end iterator
+        while( itLeaf.length() == level  && itCand !=  Iterator()  ) // here the default iterator represent an end iterator
         {
          
             if( testSubset( itLeaf, itCand, buffer ) )  // test if all the subsets of the set composed by node of itLeaf + node itCand are in the trie 
             {
                 elem = itCand.element() ;  
-                cand.addToNode( itLeaf, & elem, &elem+1 )  ;
+                typename Cand_DataStruct::iterator position = candIterator( cand, itLeaf ) ;
+                cand.addToNode( position, & elem, &elem+1 )  ;
                 nb++;
             }
             itCand = itCand.nextChildNode(); 
@@ -451,6 +772,199 @@ int Apriori<  SetsType, Measure,   Cand_DataStruct>::candidatesGeneration( Cand_
     return nb;    
 }
 
+//! Candidate generation phase of Apriori with several threads.
+/**
+   \param cand set of candidates.
+   \param level current size of the candidates.
+   \param itLeaf iterator on the first leaf
+   \param end end iterator
+   \return the number of sets generated.
+*/
+template<  class SetsType ,  class Measure,  class Cand_DataStruct  > template< class Iterator >
+int Apriori<  SetsType, Measure,   Cand_DataStruct>::candidatesGenerationParallel( Cand_DataStruct & cand, int &level, Iterator itLeaf, Iterator end )
+{
+    int nb =0 ;
+    
+    // the leaves used to generate the candidates, in the order of the exploration
+    vector< Iterator > leaves ;
+    for( ; itLeaf != end ; itLeaf = itLeaf.nextLeaf() )
+         if( itLeaf.length() == level )
+             leaves.push_back( itLeaf ) ;
+    
+    // several blocks by thread, so that the threads are busy until the end
+    int blockSize = leaves.size() / ( nbThreads * 16 ) + 1 ;
+    vector< vector< pair< int, SetsType > > > results( ( leaves.size() + blockSize - 1 ) / blockSize ) ;
+    
+    atomic<int> next( 0 ) ;
+    vector< thread > threads ;
+    
+    for( int t = 0 ; t < nbThreads ; t++ )
+         threads.push_back( thread( generationThread<Iterator>( this, &leaves, &results, blockSize, &next, level ) ) ) ;
+    
+    for( int t = 0 ; t < nbThreads ; t++ )
+         threads[ t ].join() ;
+    
+    // the candidates are inserted in the order of the exploration of the leaves
+    for( int b = 0 ; b < results.size() ; b++ )
+    {
+        for( int i = 0 ; i < results[ b ].size() ; i++ )
+        {
+            SetsType elem = results[ b ][ i ].second ;
+            typename Cand_DataStruct::iterator position = candIterator( cand, leaves[ results[ b ][ i ].first ] ) ;
+            cand.addToNode( position, & elem, &elem+1 )  ;
+            nb++;
+        }
+        vector< pair< int, SetsType > >().swap( results[ b ] ) ;
+    }
+    
+    return nb;    
+}
+
+//! Estimate the memory of the candidates generated with each leaf of the current level (upper bound).
+/**
+   \param cand set of candidates.
+   \param level current size of the candidates.
+   \param leaves the leaves of the current level (in the order of the exploration)
+   \param memory the memory (in bytes) of the candidates of each leaf
+   \return the memory of all the candidates.
+*/
+template<  class SetsType ,  class Measure,  class Cand_DataStruct  > 
+long Apriori<  SetsType, Measure,   Cand_DataStruct>::candidatesMemory( Cand_DataStruct & cand, int level, vector< typename Cand_DataStruct::iterator > & leaves, vector< long > & memory )
+{
+    typedef Node< SetsType, Measure > NodeCand ;
+    
+    for( typename Cand_DataStruct::iterator itLeaf = cand.beginLeaf() ; itLeaf != cand.end() ; itLeaf = itLeaf.nextLeaf() )
+         if( itLeaf.length() == level )
+             leaves.push_back( itLeaf ) ;
+    
+    memory.assign( leaves.size(), 0 ) ;
+    
+    long total = 0 ;
+    long peak = 0 ; // memory of the biggest leaf
+    int lastId = 0 ; // internal id of the last leaf of the node
+    
+    for( int l = (int) leaves.size() - 1 ; l >= 0 ; l-- )
+    {
+         NodeCand * node = leaves[ l ].node() ;
+         
+         if( l + 1 == (int) leaves.size() || node != leaves[ l + 1 ].node() )
+             lastId = leaves[ l ].elementId() ;
+         
+         // the vectors of a node are indexed by the internal ids from the first one to the last one,
+         // and their capacity is at most twice their size
+         int span = lastId - leaves[ l ].elementId() ;
+         
+         if( span ) // the child node and its vector of measures
+             memory[ l ] = NodeArena::blockBytes( sizeof( NodeCand ) ) + NodeArena::blockBytes( sizeof( typename NodeCand::vectT ) ) 
+                           + NodeArena::blockBytes( 2 * span * sizeof( Measure ) ) ;
+         
+         // the vector of the child nodes of the node (indexed from the offset of the node), counted with its first leaf
+         if( span && ( l == 0 || node != leaves[ l - 1 ].node() ) )
+             memory[ l ] += childsMemory( node ) ;
+         
+         total += memory[ l ] ;
+         
+         if( memory[ l ] > peak ) peak = memory[ l ] ;
+    }
+    
+    return total + peak ;
+}
+
+//! Generation, count and pruning phases of Apriori for batches of leaves, so that the candidates of a batch fit in the memory budget.
+/**
+   \param cand set of candidates.
+   \param level current size of the candidates.
+   \param leaves the leaves of the current level (in the order of the exploration)
+   \param memory the memory (in bytes) of the candidates of each leaf
+   \param pred the predicate.
+   \param theory output the theory in the given objet (must have a push_back( container, measure ) method).                      
+   \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).                      
+   \param wordToSet  transform the sets in words of the language studied.
+   \param stopIte functor stop that stop the execution of apriori before the end.
+   \param setToWordSave  transform for output the sets find by the algorithm in words of the language.               
+   \return the number of candidates respecting the predicate.
+*/
+template<  class SetsType ,  class Measure,  class Cand_DataStruct  > template< class Predicate, class OutputTheory, class OutputBdN, class f, class StopIteration, class f2 >
+int Apriori<  SetsType, Measure,   Cand_DataStruct>::batchesGeneration( Cand_DataStruct & cand, int &level, vector< typename Cand_DataStruct::iterator > & leaves, vector< long > & memory,
+                                                                       Predicate * pred, OutputTheory * theory, OutputBdN * bdN, f & wordToSet, StopIteration * stopIte, f2 & wordToSetSave )
+{
+    int nbTheory = 0 ; // number of candidates respecting the predicate
+    int nbBatches = 0 ;
+    int nbCand = 0 ;
+    
+    int first = 0 ; // first leaf of the batch
+    
+    // the biggest vector can be reallocated while the old one is not released yet (see candidatesMemory())
+    long peak = leaves.empty() ? 0 : *max_element( memory.begin(), memory.end() ) ;
+    
+    // minimal memory of a batch, so that the level is processed in about maxBatches batches at most
+    long minBatch = accumulate( memory.begin(), memory.end(), 0L ) / ( maxBatches > 0 ? maxBatches : 1 ) ;
+    
+    while( first < (int) leaves.size() )
+    {
+        if( ! memory[ first ] ) // the leaf does not generate candidates (the last leaf of its node)
+        {
+            ++first ;
+            continue ;
+        }
+        
+        // the memory available for the candidates of the batch (the trie contains the candidates kept from the precedent batches)
+        long available = memoryBudget - arena.bytesUsed - peak ;
+        
+        if( available < minBatch )
+        {
+            if( ! budgetExceeded )
+                cerr<<"Apriori: the trie uses "<<arena.bytesUsed<<" bytes, the memory budget of "<<memoryBudget<<" bytes may be exceeded from level "<<level+1<<endl;
+            
+            budgetExceeded = true ;
+            available = minBatch ;
+        }
+        
+        long used = memory[ first ] ;
+        
+        // the vector of the child nodes of the node is counted with its first leaf, which is in a precedent batch
+        if( first && leaves[ first ].node() == leaves[ first - 1 ].node() )
+            used += childsMemory( leaves[ first ].node() ) ;
+        
+        int last = first + 1 ; // first leaf of the next batch
+        while( last < (int) leaves.size() && used + memory[ last ] <= available )
+               used += memory[ last++ ] ;
+        
+        // the new candidates are stored in the child nodes of the leaves, so the leaves of the next batches stay valid
+        int nb = candidatesGeneration( cand, level, leaves[ first ], last < (int) leaves.size() ? leaves[ last ] : cand.end() ) ;
+        
+        if( nb )
+        {
+            // Preprocessing of the candidates (the candidates of the precedent batches are already counted)
+            pred->preProcessing( cand, wordToSet );
+            
+            // update the stop functor with the actual  information about the execution
+            if( stopIte )
+                stopIte->update( cand ) ;
+            
+            // the sets kept are inserted in the index of the next level, the index of this level is used to generate the next batches
+            subsetHash.swap( nextSubsetHash ) ;
+            
+            // the candidates of the precedent batches are the first leaves of the level
+            nbTheory += nb - prune( cand, pred, theory, bdN, wordToSet, wordToSetSave, 0, nbTheory ) ;
+            
+            subsetHash.swap( nextSubsetHash ) ;
+        }
+        
+        nbCand += nb ;
+        ++nbBatches ;
+        first = last ;
+    }
+    
+    // the sets of the precedent level are not used anymore
+    subsetHash.swap( nextSubsetHash ) ;
+    nextSubsetHash.clear() ;
+    
+    if( verbose ) cout<<" Batches:"<<nbBatches<<" Cand:"<<nbCand;
+    
+    return nbTheory ;
+}
+
 // ----------------------------------------------------------------------------------------------
 
 //! Test if a set generated using the elements pointed by itPref and itLast is a candidate.
@@ -466,6 +980,9 @@ bool Apriori<  SetsType, Measure,   Cand_DataStruct >::testSubset( Iterator & it
     Iterator itParent ; // iterator on the parent node
     Iterator itSearch ; // iterator used to search elem in child nodes
 
+    if( itLast != Iterator() && subsetHash.setsLength() == itPref.length() ) // the subsets are searched in the hash index 
+        return subsetHash.testSubsets( itPref, itLast ) ;
+        
     if( itLast != Iterator() )    // it is not the last child node of the parent node
     {
         buffer.push_back( itLast.element() ); //second subset (with same prefix) tested 
@@ -515,10 +1032,11 @@ bool Apriori<  SetsType, Measure,   Cand_DataStruct >::testSubset( Iterator & it
    \param pred the predicate.
    \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).                         
    \param listInterestItems list of all the interesting items (set representation).                
+   \param skip number of candidates already tested (the first leaves of the last level, tested with a precedent batch).
    \return the number of candidates pruned.
 */
 template< class SetsType , class Measure,    class Cand_DataStruct  > template< class Predicate, class OutputTheory , class OutputBdN, class f, class f2  >
-int Apriori<  SetsType,  Measure,    Cand_DataStruct >::prune(  Cand_DataStruct & cand,  Predicate  * pred,  OutputTheory * theory  , OutputBdN * bdN, f & wordToSet, f2 & wordToSetSave, deque<SetsType> * listInteresItems)
+int Apriori<  SetsType,  Measure,    Cand_DataStruct >::prune(  Cand_DataStruct & cand,  Predicate  * pred,  OutputTheory * theory  , OutputBdN * bdN, f & wordToSet, f2 & wordToSetSave, deque<SetsType> * listInteresItems, int skip)
 { 
        
     typename Cand_DataStruct::iterator itLeaf = cand.beginLeaf(); // iterator on the leafs of the trie
@@ -526,14 +1044,26 @@ int Apriori<  SetsType,  Measure,    Cand_DataStruct >::prune(  Cand_DataStruct
                 
     int nbPrune = 0 ; // number of elements pruned
     
+    vector< char > results ; // result of the predicate for each candidate, when they are tested by several threads
+    int nbTested = 0 ;
+    
+    if( nbPredicateThreads > 1 )
+        testCandidates( cand, pred, wordToSet, results, skip ) ;
+    
+    if( hashSubsets && ! skip ) // the sets of this level will be used to test the subsets of the next candidates
+        subsetHash.init( cand.length(), cand.recode->size() ) ;
+    
     while( itLeaf != cand.end() )    // go throw each the leaf and test if the candidates are true wrt the predicate
     {
         itNext = itLeaf.nextLeaf(); // get  the next leaf   
       
-        if( itLeaf.length() == cand.length()  ) // we only test the last sets generated   
+        if( itLeaf.length() == cand.length() && skip ) // already tested
+            --skip ;
+        else if( itLeaf.length() == cand.length()  ) // we only test the last sets generated   
         {     
+           bool isTrue = nbPredicateThreads > 1 ? results[ nbTested++ ] : (*pred)( wordToSet.inverse(itLeaf), itLeaf.measure()  ) ;
 
-           if( !(*pred)( wordToSet.inverse(itLeaf), itLeaf.measure()  ) ) // the candidates does not respect the predicate
+           if( !isTrue ) // the candidates does not respect the predicate
            { 
                 if( bdN ) // we want to find the negative border
                 {
@@ -550,6 +1080,9 @@ int Apriori<  SetsType,  Measure,    Cand_DataStruct >::prune(  Cand_DataStruct
 
                 if( theory ) // store all the theory
                   theory->push_back( * wordToSetSave.inverse(itLeaf),  itLeaf.measure() ) ;                     
+                  
+                if( hashSubsets )
+                  subsetHash.insert( itLeaf ) ;
            }
          
         }       
@@ -560,6 +1093,75 @@ int Apriori<  SetsType,  Measure,    Cand_DataStruct >::prune(  Cand_DataStruct
     return nbPrune;         
 } 
 
+//! Test the last candidates generated wrt the predicate with nbPredicateThreads threads.
+/**
+   \param cand set of candidates.
+   \param pred the predicate.
+   \param wordToSet  transform the sets in words of the language studied.
+   \param results stores the result of the predicate for each candidate (in the order of the leaves).
+   \param skip number of candidates already tested (not tested again).
+*/
+template< class SetsType , class Measure,    class Cand_DataStruct  > template< class Predicate, class f >
+void Apriori<  SetsType,  Measure,    Cand_DataStruct >::testCandidates(  Cand_DataStruct & cand,  Predicate  * pred, f & wordToSet, vector< char > & results, int skip )
+{
+    // the candidates to test, in the order of the leaves
+    vector< typename Cand_DataStruct::iterator > cands ;
+    for( typename Cand_DataStruct::iterator itLeaf = cand.beginLeaf() ; itLeaf != cand.end() ; itLeaf = itLeaf.nextLeaf() )
+         if( itLeaf.length() == cand.length() && skip )
+             --skip ;
+         else if( itLeaf.length() == cand.length() )
+             cands.push_back( itLeaf ) ;
+    
+    results.assign( cands.size(), 0 ) ;
+    
+    // several blocks by thread, so that the threads are busy until the end
+    int blockSize = cands.size() / ( nbPredicateThreads * 16 ) + 1 ;
+    
+    atomic<int> next( 0 ) ;
+    vector< thread > threads ;
+    
+    for( int t = 0 ; t < nbPredicateThreads ; t++ )
+         threads.push_back( thread( predicateThread< Predicate, f >( pred, wordToSet, &cands, &results, blockSize, &next ) ) ) ;
+    
+    for( int t = 0 ; t < nbPredicateThreads ; t++ )
+         threads[ t ].join() ;
+}
+
+// ----------------------------------------------------------------------------------------------
+
+//! Output the sets of a trie which are not included in another one of the trie (ie the elements of the positive border).
+/**
+   The sets are processed by decreasing size, and a set is maximal if it is not included in one of the maximal sets already found.
+   \param maximals trie storing the sets without interesting superset among the sets explored.
+   \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+   \param wordToSetSave  transform for output the sets find by the algorithm in words of the language.
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class OutputBdP, class f2 >
+void Apriori< SetsType, Measure, Cand_DataStruct >::outputMaximals( Cand_DataStruct & maximals, OutputBdP * bdP, f2 & wordToSetSave )
+{
+    // the sets by size
+    vector< vector< typename Cand_DataStruct::iterator > > sets( maximals.length() + 1 ) ;
+
+    for( typename Cand_DataStruct::iterator it = maximals.beginLeaf() ; it != maximals.end() ; it = it.nextLeaf() )
+         sets[ it.length() ].push_back( it ) ;
+
+    SetIndex< SetsType, Measure > index ;
+
+    for( int l = sets.size() - 1 ; l > 0 ; l-- )
+    {
+         for( int s = 0 ; s < sets[ l ].size() ; s++ )
+         {
+              vectUI & vect = * sets[ l ][ s ].getInternalset() ;
+
+              if( ! index.include( &vect ) )
+              {
+                  bdP->push_back( * wordToSetSave.inverse( sets[ l ][ s ] ), sets[ l ][ s ].measure() ) ;
+                  index.insert( vect ) ;
+              }
+         }
+    }
+}
+
 // ----------------------------------------------------------------------------------------------
 
 //! Erase all the k-1 subsets of the set of size k coresponding to the iterator in parameter.
@@ -619,8 +1221,6 @@ void Apriori<   SetsType,  Measure,  Cand_DataStruct >::eraseSubset( Cand_DataSt
 template<  class SetsType ,class Measure,   class Cand_DataStruct  >
 void Apriori<  SetsType,  Measure,    Cand_DataStruct >::filter( Cand_DataStruct & cand )
 {
-    int nb =0 ;
-
     vector<SetsType> buffer ;                     // buffer used to find subsets
     buffer.reserve( cand.length() ) ;  // initialized here to avoid unnecessary memory allocation
     
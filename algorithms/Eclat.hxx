@@ -0,0 +1,503 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef ECLAT_HXX
+#define ECLAT_HXX
+
+#include <set>
+
+#include "Apriori.hxx"
+#include "VerticalDB.hxx"
+
+template< class Data, class SetsType > class Frequent ;
+
+//! Functor finding the theory and/or the negative border and/or the positive border with a depth-first exploration of the search space (Eclat strategy).
+/**
+    The sets of size 1 are tested as in Apriori. Then the search space is explored depth first by prefix equivalence classes:
+    the class of a prefix P contains the interesting sets P + {e}, and the candidates generated from this class are the sets P + {e, e'}
+    such that P + {e} and P + {e'} are interesting (e < e').
+    The candidates of a class are stored in a trie, processed by the predicate (preProcessing) and tested, and then the trie is deleted
+    before exploring the classes of the interesting candidates.
+    So only the classes of the current path are stored in memory, instead of a complete level of the search space.
+
+    Any predicate can be used. The measures of the candidates of a class are computed by the preProcessing of the predicate,
+    so the exploration is efficient only when the predicate does not scan all the data for each class.
+    With the predicate Frequent, the bitmaps of the transactions containing the interesting items are built once from the db (Tatree or vertical db),
+    and the bitmap of each interesting set is passed down to its class: the support of a candidate P + {e, e'} is the number of transactions
+    in the intersection of the bitmaps of P + {e} and P + {e'}, so the db is not scanned again.
+
+    The negative border is found by testing the subsets of the candidates not interesting (they are not all stored during the exploration).
+    The positive border is found among the sets without interesting extension in their class, the sets included in another one are removed at the end.
+
+    The template parameter SetsType represents the type of the sets representing the elements of the language.
+    The template parameter Measure is the type of the value eventually associated with the word of the language.
+    The template parameter Cand_DataStruct is the data structure type used to store the candidates generated by the algorithms.
+*/
+template< class SetsType=int, class Measure=Boolean, class Cand_DataStruct = PTree<SetsType,Measure> >
+class Eclat: public Apriori<SetsType,Measure,Cand_DataStruct>
+{
+    protected:
+
+        typedef VerticalDB<int>::Bitmap Bitmap ;
+
+        //! Bitmaps of the transactions containing each interesting item (only built with the predicate Frequent)
+        VerticalDB<int> vertical ;
+
+        //! Bitmap of the items not in the db
+        Bitmap noTids ;
+
+        //! Return the bitmap of the transactions containing an item
+        const Bitmap & itemTids( int item ){ return item < vertical.nbElements() ? vertical.bitmap( item ) : noTids ; }
+
+        //! Build the bitmaps of the interesting items from the db of the predicate Frequent
+        /**
+           \param pred the predicate.
+           \return true, the supports of the sets are computed with the bitmaps.
+        */
+        template< class Data, class SetsTypeDB >
+        bool buildVertical( Frequent<Data,SetsTypeDB> * pred ){ vertical.build( pred->getDB()->data() ) ; return true ; }
+
+        //! The measures of the sets are computed by the preProcessing of the other predicates (no bitmap is built)
+        template< class Predicate >
+        bool buildVertical( Predicate * pred ){ return false ; }
+
+        //! Compute the support of the candidates of a class by intersecting the bitmaps of the sets of the class
+        /**
+           \param cand the candidates of the class, ie the sets prefix + { ext[i], ext[j] } with i < j.
+           \param tids bitmap of each set of the class.
+           \param candTids output the bitmap of each candidate in the order of the leaves (empty if the candidate is not frequent).
+           \param pred the predicate.
+           \param wordToSet  transform words of the language studied in sets.
+        */
+        template< class Data, class SetsTypeDB, class f >
+        void countClass( Cand_DataStruct & cand, vector< Bitmap > & tids, vector< Bitmap > & candTids, Frequent<Data,SetsTypeDB> * pred, f & wordToSet ) ;
+
+        //! Compute the measures of the candidates of a class with the preProcessing of the predicate (no bitmap)
+        template< class Predicate, class f >
+        void countClass( Cand_DataStruct & cand, vector< Bitmap > & tids, vector< Bitmap > & candTids, Predicate * pred, f & wordToSet ){ pred->preProcessing( cand, wordToSet ) ; }
+
+        //! Compute the support of some sets by intersecting the bitmaps of their items
+        /**
+           \param subsets the sets.
+           \param pred the predicate.
+           \param wordToSet  transform words of the language studied in sets.
+        */
+        template< class Data, class SetsTypeDB, class f >
+        void countSubsets( Cand_DataStruct & subsets, Frequent<Data,SetsTypeDB> * pred, f & wordToSet ) ;
+
+        //! Compute the measures of some sets with the preProcessing of the predicate
+        template< class Predicate, class f >
+        void countSubsets( Cand_DataStruct & subsets, Predicate * pred, f & wordToSet ){ pred->preProcessing( subsets, wordToSet ) ; }
+
+        //! Explore a prefix equivalence class, and recursively the classes of its interesting candidates.
+        /**
+           \param prefix internal ids of the prefix of the class (restored at the end).
+           \param ext internal ids of the elements extending the prefix (in increasing order), ie the sets of the class are prefix + { ext[i] }.
+           \param measures measure of each set of the class.
+           \param tids bitmap of each set of the class (empty if the bitmaps are not used, released after the count of the candidates).
+           \param pred the predicate.
+           \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+           \param maximals trie storing the sets without interesting extension (0 if the positive border is not searched).
+           \param wordToSet  transform words of the language studied in sets.
+           \param wordToSetSave  transform for output the sets find by the algorithm in words of the language.
+        */
+        template< class Predicate, class OutputTheory, class OutputBdN, class f, class f2 >
+        void exploreClass( vectUI & prefix, vector< int > & ext, vector< Measure > & measures, vector< Bitmap > & tids, Predicate * pred, OutputTheory * theory, OutputBdN * bdN,
+                           Cand_DataStruct * maximals, f & wordToSet, f2 & wordToSetSave ) ;
+
+        //! Output the candidates not interesting of a class whose subsets are all interesting (ie the elements of the negative border).
+        /**
+           \param prefix internal ids of the prefix of the class.
+           \param negatives iterators on the candidates not interesting of the class.
+           \param pred the predicate.
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+           \param wordToSet  transform words of the language studied in sets.
+           \param wordToSetSave  transform for output the sets find by the algorithm in words of the language.
+        */
+        template< class Predicate, class OutputBdN, class f, class f2 >
+        void outputBdN( vectUI & prefix, vector< typename Cand_DataStruct::iterator > & negatives, Predicate * pred, OutputBdN * bdN, f & wordToSet, f2 & wordToSetSave ) ;
+
+    public:
+
+        //! Constructor
+        Eclat():Apriori<SetsType,Measure,Cand_DataStruct>(){}
+
+        // ! Destructor
+        ~Eclat(){ }
+
+        //! Function that execute the algorithm.
+        /**
+           \param init functor initializing the interesting items wrt predicate.
+           \param pred the predicate
+           \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+           \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+           \param wordToSet  transform words of the language studied in sets.
+           \param wordToSetSave  transform for output the sets find by the algorithm in words of the language.
+        */
+        template< class InitFunctor, class Predicate, class OutputTheory, class OutputBdP, class OutputBdN, class f, class f2 >
+        void executeAlgo( InitFunctor & init, Predicate * pred, OutputTheory * theory, OutputBdP * bdP, OutputBdN * bdN, f & wordToSet, f2 & wordToSetSave ) ;
+
+        //! Functor operator that executes the algorithm.
+        /**
+           \param init functor initializing the interesting items wrt predicate.
+           \param pred the predicate
+           \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+           \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+           \param wordToSet  transform words of the language studied in sets.
+        */
+        template<  class InitFunctor, class Predicate, class OutputTheory , class OutputBdP, class OutputBdN, class f   >
+        void operator() (  InitFunctor & init, Predicate  & pred, OutputTheory * theory , OutputBdP * bdP, OutputBdN * bdN, f & wordToSet )
+        {
+             executeAlgo( init, &pred, theory, bdP, bdN, wordToSet, wordToSet ) ;
+        }
+
+        //! Functor operator that executes the algorithm.
+        /**
+           \param init functor initializing the interesting items wrt predicate.
+           \param pred the predicate
+           \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+           \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+        */
+        template<  class InitFunctor, class Predicate, class OutputTheory , class OutputBdP, class OutputBdN   >
+        void operator() (  InitFunctor & init, Predicate  & pred, OutputTheory * theory , OutputBdP * bdP, OutputBdN * bdN)
+        {
+             Id identity;
+             executeAlgo( init, &pred, theory, bdP, bdN, identity, identity ) ;
+        }
+};
+
+// ----------------------------------------------------------------------------------------------
+
+//! Function that execute the algorithm.
+/**
+   \param init functor initializing the interesting items wrt predicate.
+   \param pred the predicate
+   \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+   \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+   \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+   \param wordToSet  transform words of the language studied in sets.
+   \param wordToSetSave  transform for output the sets find by the algorithm in words of the language.
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class InitFunctor, class Predicate, class OutputTheory, class OutputBdP, class OutputBdN, class f, class f2 >
+void Eclat< SetsType, Measure, Cand_DataStruct >::executeAlgo( InitFunctor & init, Predicate * pred, OutputTheory * theory, OutputBdP * bdP, OutputBdN * bdN, f & wordToSet, f2 & wordToSetSave )
+{
+    clock_t startall = clock();
+
+    Cand_DataStruct & candidates = this->candidates ;
+
+    // the sets of size 1 are found as in Apriori
+
+    if( this->verbose ) cout<<" LEVEL :1";
+
+    init() ;
+
+    for_each( init.listElements.begin(), init.listElements.end(), typename Apriori<SetsType,Measure,Cand_DataStruct>::template initCandidates<f>( candidates, wordToSet ) ) ;
+
+    pred->preProcessing( candidates, wordToSet );
+
+    int nbSet = candidates.size() ;
+
+    nbSet -= this->prune( candidates, pred, theory, bdN, wordToSet, wordToSetSave );
+
+    pred->postProcessing( candidates, wordToSet );
+
+    if( this->verbose ) cout<<" Theory:"<<nbSet<<endl;
+
+    // the class of the empty prefix contains the interesting sets of size 1
+
+    vectUI prefix ;
+    vector< int > ext ;
+    vector< Measure > measures ;
+    vector< Bitmap > tids ;
+
+    bool useBitmaps = buildVertical( pred ) ; // the db only contains the interesting items after the postProcessing
+
+    for( typename Cand_DataStruct::iterator it = candidates.beginLeaf() ; it != candidates.end() ; it = it.nextLeaf() )
+    {
+         ext.push_back( it.elementId() ) ;
+         measures.push_back( it.measure() ) ;
+
+         if( useBitmaps )
+             tids.push_back( itemTids( it.elementId() ) ) ;
+    }
+
+    Cand_DataStruct maximals( 0, 0, 0, candidates.recode ) ;
+
+    exploreClass( prefix, ext, measures, tids, pred, theory, bdN, bdP ? &maximals : 0, wordToSet, wordToSetSave ) ;
+
+    if( bdP )
+        this->outputMaximals( maximals, bdP, wordToSetSave ) ;
+
+    if( this->verbose ){ cout<<"Totat execution time ["<<(clock()-startall)/CLOCKS_PER_SEC<<"s]"<<endl; cout<<endl;}
+}
+
+// ----------------------------------------------------------------------------------------------
+
+//! Explore a prefix equivalence class, and recursively the classes of its interesting candidates.
+/**
+   \param prefix internal ids of the prefix of the class (restored at the end).
+   \param ext internal ids of the elements extending the prefix (in increasing order), ie the sets of the class are prefix + { ext[i] }.
+   \param measures measure of each set of the class.
+   \param tids bitmap of each set of the class (empty if the bitmaps are not used, released after the count of the candidates).
+   \param pred the predicate.
+   \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+   \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+   \param maximals trie storing the sets without interesting extension (0 if the positive border is not searched).
+   \param wordToSet  transform words of the language studied in sets.
+   \param wordToSetSave  transform for output the sets find by the algorithm in words of the language.
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class Predicate, class OutputTheory, class OutputBdN, class f, class f2 >
+void Eclat< SetsType, Measure, Cand_DataStruct >::exploreClass( vectUI & prefix, vector< int > & ext, vector< Measure > & measures, vector< Bitmap > & tids, Predicate * pred, OutputTheory * theory, OutputBdN * bdN,
+                                                                 Cand_DataStruct * maximals, f & wordToSet, f2 & wordToSetSave )
+{
+    int n = ext.size() ;
+    int d = prefix.size() ;
+
+    // the classes of the sets prefix + { ext[i] }
+    vector< vector< int > > childExt( n ) ;
+    vector< vector< Measure > > childMeasures( n ) ;
+    vector< vector< Bitmap > > childTids( n ) ;
+
+    if( n > 1 )
+    {
+        // the candidates of the class
+        Cand_DataStruct cand( 0, 0, 0, this->candidates.recode ) ;
+
+        vectUI candSet( prefix ) ;
+        candSet.resize( d + 2 ) ;
+
+        for( int i = 0 ; i < n ; i++ )
+        {
+             candSet[ d ] = ext[ i ] ;
+             for( int j = i + 1 ; j < n ; j++ )
+             {
+                  candSet[ d + 1 ] = ext[ j ] ;
+                  cand.insert( &candSet ) ;
+             }
+        }
+
+        vector< Bitmap > candTids ;
+
+        countClass( cand, tids, candTids, pred, wordToSet ) ;
+
+        vector< Bitmap >().swap( tids ) ; // the bitmaps of the candidates are enough for the next classes
+
+        vector< char > results ; // result of the predicate for each candidate, when they are tested by several threads
+        int nbTested = 0 ;
+
+        if( this->nbPredicateThreads > 1 )
+            this->testCandidates( cand, pred, wordToSet, results ) ;
+
+        vector< typename Cand_DataStruct::iterator > negatives ;
+
+        typename Cand_DataStruct::iterator itNext ;
+        int i = 0 ;
+        int c = 0 ;
+
+        for( typename Cand_DataStruct::iterator it = cand.beginLeaf() ; it != cand.end() ; it = itNext, c++ )
+        {
+             itNext = it.nextLeaf() ; // the measure of the candidate is modified by the predicate
+
+             bool isTrue = this->nbPredicateThreads > 1 ? results[ nbTested++ ] : (*pred)( wordToSet.inverse( it ), it.measure() ) ;
+
+             while( ext[ i ] != it.parentNode().elementId() ) // the leaves are in the order of the classes
+                    i++ ;
+
+             if( isTrue )
+             {
+                 childExt[ i ].push_back( it.elementId() ) ;
+                 childMeasures[ i ].push_back( it.measure() ) ;
+
+                 if( candTids.size() )
+                 {
+                     childTids[ i ].push_back( Bitmap() ) ;
+                     childTids[ i ].back().swap( candTids[ c ] ) ;
+                 }
+
+                 if( theory )
+                     theory->push_back( * wordToSetSave.inverse( it ), it.measure() ) ;
+             }
+             else if( bdN )
+                 negatives.push_back( it ) ;
+        }
+
+        if( negatives.size() )
+            outputBdN( prefix, negatives, pred, bdN, wordToSet, wordToSetSave ) ;
+
+    } // the candidates are deleted before exploring the next classes
+
+    prefix.push_back( 0 ) ;
+
+    for( int i = 0 ; i < n ; i++ )
+    {
+         prefix.back() = ext[ i ] ;
+
+         if( childExt[ i ].size() )
+             exploreClass( prefix, childExt[ i ], childMeasures[ i ], childTids[ i ], pred, theory, bdN, maximals, wordToSet, wordToSetSave ) ;
+         else if( maximals ) // the set has no interesting extension in its class
+             maximals->insert( &prefix, measures[ i ] ) ;
+
+         vector< int >().swap( childExt[ i ] ) ;
+         vector< Measure >().swap( childMeasures[ i ] ) ;
+         vector< Bitmap >().swap( childTids[ i ] ) ;
+    }
+
+    prefix.pop_back() ;
+}
+
+// ----------------------------------------------------------------------------------------------
+
+//! Output the candidates not interesting of a class whose subsets are all interesting (ie the elements of the negative border).
+/**
+   The subsets prefix + { e, e' } - { p } of the candidates are tested with the predicate (the subsets without e or e' are in the class).
+   \param prefix internal ids of the prefix of the class.
+   \param negatives iterators on the candidates not interesting of the class.
+   \param pred the predicate.
+   \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+   \param wordToSet  transform words of the language studied in sets.
+   \param wordToSetSave  transform for output the sets find by the algorithm in words of the language.
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class Predicate, class OutputBdN, class f, class f2 >
+void Eclat< SetsType, Measure, Cand_DataStruct >::outputBdN( vectUI & prefix, vector< typename Cand_DataStruct::iterator > & negatives, Predicate * pred, OutputBdN * bdN, f & wordToSet, f2 & wordToSetSave )
+{
+    int d = prefix.size() ;
+
+    // the subsets of the candidates which are interesting
+    set< vectUI > interesting ;
+
+    if( d )
+    {
+        Cand_DataStruct subsets( 0, 0, 0, this->candidates.recode ) ;
+
+        vectUI subset ;
+
+        for( int c = 0 ; c < negatives.size() ; c++ )
+        {
+             vectUI & candSet = * negatives[ c ].getInternalset() ;
+
+             for( int p = 0 ; p < d ; p++ )
+             {
+                  subset.assign( candSet.begin(), candSet.begin() + p ) ;
+                  subset.insert( subset.end(), candSet.begin() + p + 1, candSet.end() ) ;
+                  subsets.insert( &subset ) ;
+             }
+        }
+
+        countSubsets( subsets, pred, wordToSet ) ;
+
+        typename Cand_DataStruct::iterator itNext ;
+
+        for( typename Cand_DataStruct::iterator it = subsets.beginLeaf() ; it != subsets.end() ; it = itNext )
+        {
+             itNext = it.nextLeaf() ;
+
+             if( (*pred)( wordToSet.inverse( it ), it.measure() ) )
+                 interesting.insert( * it.getInternalset() ) ;
+        }
+    }
+
+    vectUI subset ;
+
+    for( int c = 0 ; c < negatives.size() ; c++ )
+    {
+         vectUI & candSet = * negatives[ c ].getInternalset() ;
+
+         bool minimal = true ;
+
+         for( int p = 0 ; p < d && minimal ; p++ )
+         {
+              subset.assign( candSet.begin(), candSet.begin() + p ) ;
+              subset.insert( subset.end(), candSet.begin() + p + 1, candSet.end() ) ;
+              minimal = interesting.count( subset ) ;
+         }
+
+         if( minimal )
+             bdN->push_back( * wordToSetSave.inverse( negatives[ c ] ), negatives[ c ].measure() ) ;
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+
+//! Compute the support of the candidates of a class by intersecting the bitmaps of the sets of the class
+/**
+   \param cand the candidates of the class, ie the sets prefix + { ext[i], ext[j] } with i < j.
+   \param tids bitmap of each set of the class.
+   \param candTids output the bitmap of each candidate in the order of the leaves (empty if the candidate is not frequent).
+   \param pred the predicate.
+   \param wordToSet  transform words of the language studied in sets.
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class Data, class SetsTypeDB, class f >
+void Eclat< SetsType, Measure, Cand_DataStruct >::countClass( Cand_DataStruct & cand, vector< Bitmap > & tids, vector< Bitmap > & candTids, Frequent<Data,SetsTypeDB> * pred, f & wordToSet )
+{
+    int n = tids.size() ;
+    int minsup = pred->getMinsup() ;
+    int c = 0 ;
+
+    candTids.resize( n * ( n - 1 ) / 2 ) ;
+
+    typename Cand_DataStruct::iterator it = cand.beginLeaf() ;
+
+    for( int i = 0 ; i < n ; i++ )
+         for( int j = i + 1 ; j < n ; j++, c++, it = it.nextLeaf() ) // the leaves are in the order of the insertion
+         {
+              it.measure().supp = VerticalDB<int>::intersect( tids[ i ], tids[ j ] ) ;
+
+              if( it.measure().supp >= minsup ) // only the bitmaps of the frequent candidates are kept
+                  VerticalDB<int>::intersect( tids[ i ], tids[ j ], &candTids[ c ] ) ;
+         }
+}
+
+//! Compute the support of some sets by intersecting the bitmaps of their items
+/**
+   The sets have the same size and are explored in lexicographic order, so the intersections of the prefix shared with the previous set are reused.
+   \param subsets the sets.
+   \param pred the predicate.
+   \param wordToSet  transform words of the language studied in sets.
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class Data, class SetsTypeDB, class f >
+void Eclat< SetsType, Measure, Cand_DataStruct >::countSubsets( Cand_DataStruct & subsets, Frequent<Data,SetsTypeDB> * pred, f & wordToSet )
+{
+    vector< Bitmap > inter ; // inter[ k ] is the bitmap of the k + 1 first items of the current set (k > 0)
+    vectUI previous ;
+
+    for( typename Cand_DataStruct::iterator it = subsets.beginLeaf() ; it != subsets.end() ; it = it.nextLeaf() )
+    {
+         vectUI & subset = * it.getInternalset() ;
+         int last = subset.size() - 1 ;
+         int k = 0 ;
+
+         while( k < last && k < previous.size() && subset[ k ] == previous[ k ] ) // prefix shared with the previous set
+                k++ ;
+
+         inter.resize( last ) ;
+         for( k = max( k, 1 ) ; k < last ; k++ )
+              VerticalDB<int>::intersect( k == 1 ? itemTids( subset[ 0 ] ) : inter[ k - 1 ], itemTids( subset[ k ] ), &inter[ k ] ) ;
+
+         it.measure().supp = VerticalDB<int>::intersect( last == 1 ? itemTids( subset[ 0 ] ) : inter[ last - 1 ], itemTids( subset[ last ] ) ) ;
+
+         previous = subset ;
+    }
+}
+
+#endif
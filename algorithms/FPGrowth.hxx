@@ -0,0 +1,283 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FPGROWTH_HXX
+#define FPGROWTH_HXX
+
+#include "Apriori.hxx"
+#include "FPTree.hxx"
+
+//! Functor finding the frequent itemsets and/or the negative border and/or the positive border with the FP-growth algorithm.
+/**
+    The frequent items are found as in Apriori, and then the database reconstructed by the predicate (a Tatree of the transactions
+    with only the frequent items) is copied in a FP-tree. The itemsets are found by recursive construction of the conditional FP-trees,
+    without generating candidates: the itemsets of the FP-tree of a suffix S are S + { i } for each item i of the tree,
+    and the FP-tree of S + { i } contains the items j < i such that S + { i, j } is frequent.
+    At each level, the items are processed in increasing order, so when S + { i } is found all its subsets are already found.
+
+    The negative border is found among the sets S + { i, j } not frequent (their support is computed with the conditional FP-tree of i),
+    their subsets are searched in a trie of the frequent itemsets (only stored if the negative border is searched).
+    The positive border is found among the sets with an empty conditional FP-tree, the sets included in another one are removed at the end.
+
+    Only the predicate Frequent with a db stored in a Tatree (or Tatree_base) can be used, and the sets cannot be transformed (no wordToSet functor).
+
+    The template parameter SetsType represents the type of the items.
+    The template parameter Measure is the type of the value associated with the itemsets (the support).
+    The template parameter Cand_DataStruct is the data structure type used to store the candidates generated by the algorithms.
+*/
+template< class SetsType=int, class Measure=Support, class Cand_DataStruct = PTree<SetsType,Measure> >
+class FPGrowth: public Apriori<SetsType,Measure,Cand_DataStruct>
+{
+    protected:
+
+        //! Find the frequent items as in Apriori, and copy the db reconstructed with them in a FP-tree.
+        /**
+           \param init functor initializing the frequent items.
+           \param pred the predicate (Frequent)
+           \param theory output the frequent items in the given objet (must have a push_back( container, measure ) method).
+           \param bdN output the items not frequent in the given objet (must have a push_back( container, measure ) method).
+           \param tree the FP-tree.
+        */
+        template< class InitFunctor, class Predicate, class OutputTheory, class OutputBdN >
+        void buildTree( InitFunctor & init, Predicate * pred, OutputTheory * theory, OutputBdN * bdN, FPTree<int> & tree ) ;
+
+        //! Find the frequent itemsets of a FP-tree, and recursively of its conditional FP-trees.
+        /**
+           \param tree the FP-tree of the suffix.
+           \param suffix internal ids of the suffix in decreasing order (restored at the end).
+           \param minsup the minimum support threshold (absolute).
+           \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+           \param frequents trie storing the frequent itemsets of size greater than 1 (0 if the negative border is not searched).
+           \param maximals trie storing the itemsets with an empty conditional FP-tree (0 if the positive border is not searched).
+        */
+        template< class OutputTheory, class OutputBdN >
+        void mine( FPTree<int> & tree, vectUI & suffix, int minsup, OutputTheory * theory, OutputBdN * bdN,
+                   Cand_DataStruct * frequents, Cand_DataStruct * maximals ) ;
+
+        //! Return true if an itemset is stored in a trie
+        /**
+           \param trie the trie.
+           \param itemset internal ids of the itemset (in increasing order).
+        */
+        bool isStored( Cand_DataStruct & trie, vectUI & itemset )
+        {
+            if( ! trie.getHead() )
+                return false ;
+
+            typename Cand_DataStruct::iterator it = trie.beginRoot() ;
+
+            for( int e = 0 ; e < itemset.size() && it != trie.end() ; e++ )
+                 it = it.childNodeId( itemset[ e ] ) ;
+
+            return it != trie.end() ;
+        }
+
+    public:
+
+        //! Constructor
+        FPGrowth():Apriori<SetsType,Measure,Cand_DataStruct>(){}
+
+        // ! Destructor
+        ~FPGrowth(){ }
+
+        //! Function that execute the algorithm.
+        /**
+           \param init functor initializing the frequent items.
+           \param pred the predicate (Frequent)
+           \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+           \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+        */
+        template< class InitFunctor, class Predicate, class OutputTheory, class OutputBdP, class OutputBdN >
+        void executeAlgo( InitFunctor & init, Predicate * pred, OutputTheory * theory, OutputBdP * bdP, OutputBdN * bdN ) ;
+
+        //! Functor operator that executes the algorithm.
+        /**
+           \param init functor initializing the frequent items.
+           \param pred the predicate (Frequent)
+           \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+           \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+        */
+        template<  class InitFunctor, class Predicate, class OutputTheory , class OutputBdP, class OutputBdN   >
+        void operator() (  InitFunctor & init, Predicate  & pred, OutputTheory * theory , OutputBdP * bdP, OutputBdN * bdN)
+        {
+             executeAlgo( init, &pred, theory, bdP, bdN ) ;
+        }
+};
+
+// ----------------------------------------------------------------------------------------------
+
+//! Function that execute the algorithm.
+/**
+   \param init functor initializing the frequent items.
+   \param pred the predicate (Frequent)
+   \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+   \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+   \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class InitFunctor, class Predicate, class OutputTheory, class OutputBdP, class OutputBdN >
+void FPGrowth< SetsType, Measure, Cand_DataStruct >::executeAlgo( InitFunctor & init, Predicate * pred, OutputTheory * theory, OutputBdP * bdP, OutputBdN * bdN )
+{
+    clock_t startall = clock();
+
+    Cand_DataStruct & candidates = this->candidates ;
+    Id identity ;
+
+    FPTree<int> tree ;
+
+    buildTree( init, pred, theory, bdN, tree ) ;
+
+    Cand_DataStruct frequents( 0, 0, 0, candidates.recode ) ;
+    Cand_DataStruct maximals( 0, 0, 0, candidates.recode ) ;
+
+    vectUI suffix ;
+
+    mine( tree, suffix, pred->getMinsup(), theory, bdN, bdN ? &frequents : 0, bdP ? &maximals : 0 ) ;
+
+    tree.clear() ;
+    frequents.release() ;
+
+    if( bdP )
+        this->outputMaximals( maximals, bdP, identity ) ;
+
+    if( this->verbose ){ cout<<"Totat execution time ["<<(clock()-startall)/CLOCKS_PER_SEC<<"s]"<<endl; cout<<endl;}
+}
+
+// ----------------------------------------------------------------------------------------------
+
+//! Find the frequent items as in Apriori, and copy the db reconstructed with them in a FP-tree.
+/**
+   \param init functor initializing the frequent items.
+   \param pred the predicate (Frequent)
+   \param theory output the frequent items in the given objet (must have a push_back( container, measure ) method).
+   \param bdN output the items not frequent in the given objet (must have a push_back( container, measure ) method).
+   \param tree the FP-tree.
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class InitFunctor, class Predicate, class OutputTheory, class OutputBdN >
+void FPGrowth< SetsType, Measure, Cand_DataStruct >::buildTree( InitFunctor & init, Predicate * pred, OutputTheory * theory, OutputBdN * bdN, FPTree<int> & tree )
+{
+    Cand_DataStruct & candidates = this->candidates ;
+    Id identity ;
+
+    // the frequent items are found as in Apriori, and the db is reconstructed with them
+
+    if( this->verbose ) cout<<" LEVEL :1";
+
+    init() ;
+
+    for_each( init.listElements.begin(), init.listElements.end(), typename Apriori<SetsType,Measure,Cand_DataStruct>::template initCandidates<Id>( candidates, identity ) ) ;
+
+    pred->preProcessing( candidates, identity );
+
+    int nbSet = candidates.size() ;
+
+    nbSet -= this->prune( candidates, pred, theory, bdN, identity, identity );
+
+    pred->postProcessing( candidates, identity );
+
+    if( this->verbose ) cout<<" Theory:"<<nbSet<<endl;
+
+    clock_t start = clock();
+
+    tree.build( pred->getDB()->data() ) ;
+
+    if( this->verbose ) cout<<"FP-tree: "<<tree.size()<<" nodes ["<<(clock()-start)/CLOCKS_PER_SEC<<"s]"<<endl;
+}
+
+// ----------------------------------------------------------------------------------------------
+
+//! Find the frequent itemsets of a FP-tree, and recursively of its conditional FP-trees.
+/**
+   \param tree the FP-tree of the suffix.
+   \param suffix internal ids of the suffix in decreasing order (restored at the end).
+   \param minsup the minimum support threshold (absolute).
+   \param theory output the theory in the given objet (must have a push_back( container, measure ) method).
+   \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+   \param frequents trie storing the frequent itemsets of size greater than 1 (0 if the negative border is not searched).
+   \param maximals trie storing the itemsets with an empty conditional FP-tree (0 if the positive border is not searched).
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class OutputTheory, class OutputBdN >
+void FPGrowth< SetsType, Measure, Cand_DataStruct >::mine( FPTree<int> & tree, vectUI & suffix, int minsup, OutputTheory * theory, OutputBdN * bdN,
+                                                            Cand_DataStruct * frequents, Cand_DataStruct * maximals )
+{
+    FPTree<int> cond ;
+    vector< int > counts ;
+
+    vectUI itemset ; // suffix + { i } in increasing order
+    vectUI candSet ; // suffix + { i, j } in increasing order
+    vectUI subset ;
+
+    for( int i = 0 ; i < tree.nbItems() ; i++ )
+    {
+         suffix.push_back( tree.item( i ) ) ;
+         itemset.assign( suffix.rbegin(), suffix.rend() ) ;
+
+         Measure measure( false, tree.support( i ) ) ;
+
+         if( itemset.size() > 1 ) // the frequent items are output by the prune phase
+         {
+             if( theory )
+                 theory->push_back( this->candidates.recode->remap( itemset ), measure ) ;
+
+             if( frequents )
+                 frequents->insert( &itemset, measure ) ;
+         }
+
+         tree.conditional( i, minsup, cond, counts ) ;
+
+         if( bdN )
+         {
+             candSet.assign( 1, 0 ) ;
+             candSet.insert( candSet.end(), itemset.begin(), itemset.end() ) ;
+
+             for( int j = 0 ; j < i ; j++ )
+             {
+                  if( counts[ j ] >= minsup )
+                      continue ;
+
+                  candSet[ 0 ] = tree.item( j ) ;
+
+                  // the subsets without i or j are frequent, the others are searched in the frequent itemsets
+                  bool minimal = true ;
+
+                  for( int p = 2 ; p < candSet.size() && minimal ; p++ )
+                  {
+                       subset.assign( candSet.begin(), candSet.begin() + p ) ;
+                       subset.insert( subset.end(), candSet.begin() + p + 1, candSet.end() ) ;
+                       minimal = isStored( *frequents, subset ) ;
+                  }
+
+                  if( minimal )
+                      bdN->push_back( this->candidates.recode->remap( candSet ), Measure( false, counts[ j ] ) ) ;
+             }
+         }
+
+         if( cond.nbItems() )
+             mine( cond, suffix, minsup, theory, bdN, frequents, maximals ) ;
+         else if( maximals ) // the itemset has no frequent extension with the items j < i
+             maximals->insert( &itemset, measure ) ;
+
+         suffix.pop_back() ;
+    }
+}
+
+#endif
@@ -0,0 +1,285 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FPMAX_HXX
+#define FPMAX_HXX
+
+#include "FPGrowth.hxx"
+#include "MinTransversals.hxx"
+#include "SetIndex.hxx"
+
+//! Functor finding the positive border and/or the negative border of the frequent itemsets, without enumerating the other frequent itemsets.
+/**
+    The search space is explored depth first on the conditional FP-trees as in FP-growth, but only the maximal frequent itemsets are searched
+    (as in MAFIA, GenMax or FPMax). The node of a head H (a frequent itemset) has for tail the items of the FP-tree of H:
+        * parent equivalence pruning: the items in all the transactions of H are added to the head of its children instead of being explored.
+        * lookahead: if the FP-tree of H is a single path, H + tail is frequent, and it is the only candidate of the subtree.
+        * superset pruning: if H + tail is included in a maximal itemset already found, the subtree is not explored.
+        * progressive focusing: the inclusion tests of a node only use the maximal itemsets already found which contain its head
+          (they are selected from the list of its parent).
+    The items of a tree are explored in decreasing order, so an itemset is never included in an itemset found after it:
+    an itemset not included in the maximal itemsets already found is maximal, and it is output immediately.
+
+    The negative border is computed at the end as the minimal transversals of the complements of the positive border (see MinTransversals),
+    and the support of its itemsets is counted in the FP-tree of the db.
+
+    Only the predicate Frequent with a db stored in a Tatree (or Tatree_base) can be used, and the sets cannot be transformed (no wordToSet functor).
+
+    The template parameter SetsType represents the type of the items.
+    The template parameter Measure is the type of the value associated with the itemsets (the support).
+    The template parameter Cand_DataStruct is the data structure type used to store the candidates generated by the algorithms.
+*/
+template< class SetsType=int, class Measure=Support, class Cand_DataStruct = PTree<SetsType,Measure> >
+class FPMax: public FPGrowth<SetsType,Measure,Cand_DataStruct>
+{
+    protected:
+
+        //! Find the maximal frequent itemsets of a FP-tree, and recursively of its conditional FP-trees.
+        /**
+           \param tree the FP-tree of the head.
+           \param head internal ids of the head (restored at the end).
+           \param support the support of the head.
+           \param focus index of the maximal itemsets found containing the head (the maximal itemsets found in the subtree are added).
+           \param minsup the minimum support threshold (absolute).
+           \param found the maximal itemsets found.
+           \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+           \param maximals trie storing the maximal itemsets (0 if the negative border is not searched).
+        */
+        template< class OutputBdP >
+        void mineMax( FPTree<int> & tree, vectUI & head, int support, vector< int > & focus, int minsup,
+                      SetIndex< SetsType, Measure > & found, OutputBdP * bdP, Cand_DataStruct * maximals ) ;
+
+        //! Output the negative border, ie the minimal transversals of the complements of the maximal itemsets.
+        /**
+           \param tree the FP-tree of the db (its items are the frequent items).
+           \param maximals trie storing the maximal itemsets.
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+        */
+        template< class OutputBdN >
+        void outputBdN( FPTree<int> & tree, Cand_DataStruct & maximals, OutputBdN * bdN ) ;
+
+    public:
+
+        //! Number of threads used to compute the minimal transversals of the negative border (1 by default, ie no thread)
+        int nbTransversalThreads ;
+
+        //! Constructor
+        FPMax():FPGrowth<SetsType,Measure,Cand_DataStruct>(){ nbTransversalThreads = 1 ; }
+
+        // ! Destructor
+        ~FPMax(){ }
+
+        //! Function that execute the algorithm.
+        /**
+           \param init functor initializing the frequent items.
+           \param pred the predicate (Frequent)
+           \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+        */
+        template< class InitFunctor, class Predicate, class OutputBdP, class OutputBdN >
+        void executeAlgo( InitFunctor & init, Predicate * pred, OutputBdP * bdP, OutputBdN * bdN ) ;
+
+        //! Functor operator that executes the algorithm.
+        /**
+           \param init functor initializing the frequent items.
+           \param pred the predicate (Frequent)
+           \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+           \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+        */
+        template<  class InitFunctor, class Predicate, class OutputBdP, class OutputBdN   >
+        void operator() (  InitFunctor & init, Predicate  & pred, OutputBdP * bdP, OutputBdN * bdN)
+        {
+             executeAlgo( init, &pred, bdP, bdN ) ;
+        }
+};
+
+// ----------------------------------------------------------------------------------------------
+
+//! Function that execute the algorithm.
+/**
+   \param init functor initializing the frequent items.
+   \param pred the predicate (Frequent)
+   \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+   \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class InitFunctor, class Predicate, class OutputBdP, class OutputBdN >
+void FPMax< SetsType, Measure, Cand_DataStruct >::executeAlgo( InitFunctor & init, Predicate * pred, OutputBdP * bdP, OutputBdN * bdN )
+{
+    clock_t startall = clock();
+
+    FPTree<int> tree ;
+
+    this->buildTree( init, pred, (OutputBdP *) 0, bdN, tree ) ;
+
+    clock_t start = clock();
+
+    SetIndex< SetsType, Measure > found ;
+    Cand_DataStruct maximals( 0, 0, 0, this->candidates.recode ) ;
+
+    vectUI head ;
+    vector< int > focus ;
+
+    mineMax( tree, head, tree.size() ? tree.node( 0 ).cnt : 0, focus, pred->getMinsup(), found, bdP, bdN ? &maximals : 0 ) ;
+
+    if( this->verbose ) cout<<"Bd+: "<<found.size()<<" ["<<(clock()-start)/CLOCKS_PER_SEC<<"s]"<<endl;
+
+    if( bdN )
+        outputBdN( tree, maximals, bdN ) ;
+
+    if( this->verbose ){ cout<<"Totat execution time ["<<(clock()-startall)/CLOCKS_PER_SEC<<"s]"<<endl; cout<<endl;}
+}
+
+// ----------------------------------------------------------------------------------------------
+
+//! Find the maximal frequent itemsets of a FP-tree, and recursively of its conditional FP-trees.
+/**
+   \param tree the FP-tree of the head.
+   \param head internal ids of the head (restored at the end).
+   \param support the support of the head.
+   \param focus index of the maximal itemsets found containing the head (the maximal itemsets found in the subtree are added).
+   \param minsup the minimum support threshold (absolute).
+   \param found the maximal itemsets found.
+   \param bdP output the positive border in the given objet (must have a push_back( container, measure ) method).
+   \param maximals trie storing the maximal itemsets (0 if the negative border is not searched).
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class OutputBdP >
+void FPMax< SetsType, Measure, Cand_DataStruct >::mineMax( FPTree<int> & tree, vectUI & head, int support, vector< int > & focus, int minsup,
+                                                            SetIndex< SetsType, Measure > & found, OutputBdP * bdP, Cand_DataStruct * maximals )
+{
+    // the head and the items of the tree
+    vectUI itemset( head ) ;
+
+    for( int i = 0 ; i < tree.nbItems() ; i++ )
+    {
+         itemset.push_back( tree.item( i ) ) ;
+
+         if( tree.support( i ) < support )
+             support = tree.support( i ) ;
+    }
+
+    sort( itemset.begin(), itemset.end() ) ;
+
+    if( itemset.empty() || found.include( &itemset, focus ) ) // superset pruning
+        return ;
+
+    if( tree.singlePath() ) // lookahead: the itemset is frequent (its support is the one of the last node of the path), and maximal
+    {
+        focus.push_back( found.size() ) ;
+        found.insert( itemset ) ;
+
+        Measure measure( false, support ) ;
+
+        if( bdP )
+            bdP->push_back( this->candidates.recode->remap( itemset ), measure ) ;
+
+        if( maximals )
+            maximals->insert( &itemset, measure ) ;
+
+        return ;
+    }
+
+    FPTree<int> cond ;
+    vector< int > counts ;
+    vectUI items ; // the items added to the head
+    vector< int > childFocus ;
+
+    for( int i = tree.nbItems() - 1 ; i >= 0 ; i-- )
+    {
+         tree.conditional( i, minsup, cond, counts, true ) ;
+
+         // parent equivalence pruning: the items in all the transactions of the new head are added to it
+         items.assign( 1, tree.item( i ) ) ;
+
+         for( int j = 0 ; j < i ; j++ )
+              if( counts[ j ] == tree.support( i ) )
+                  items.push_back( tree.item( j ) ) ;
+
+         head.insert( head.end(), items.begin(), items.end() ) ;
+
+         found.select( focus, items, childFocus ) ;
+
+         int nb = found.size() ;
+
+         mineMax( cond, head, tree.support( i ), childFocus, minsup, found, bdP, maximals ) ;
+
+         // the maximal itemsets found in the subtree contain the head
+         for( int id = nb ; id < found.size() ; id++ )
+              focus.push_back( id ) ;
+
+         head.resize( head.size() - items.size() ) ;
+    }
+}
+
+// ----------------------------------------------------------------------------------------------
+
+//! Output the negative border, ie the minimal transversals of the complements of the maximal itemsets.
+/**
+   The complements are computed wrt the frequent items (the items not frequent are output by the prune phase).
+   A set is not frequent iff it is not included in a maximal itemset, ie it intersects the complements of all the maximal itemsets,
+   so the minimal not frequent itemsets are the minimal transversals of the complements.
+   Their size is at most the size of the largest maximal itemset + 1, and their support is counted in the FP-tree.
+   \param tree the FP-tree of the db (its items are the frequent items).
+   \param maximals trie storing the maximal itemsets.
+   \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+*/
+template< class SetsType, class Measure, class Cand_DataStruct > template< class OutputBdN >
+void FPMax< SetsType, Measure, Cand_DataStruct >::outputBdN( FPTree<int> & tree, Cand_DataStruct & maximals, OutputBdN * bdN )
+{
+    clock_t start = clock();
+
+    Cand_DataStruct complements( 0, 0, 0, this->candidates.recode ) ;
+
+    vectUI complement ;
+
+    for( typename Cand_DataStruct::iterator it = maximals.beginLeaf() ; it != maximals.end() ; it = it.nextLeaf() )
+    {
+         vectUI & itemset = * it.getInternalset() ;
+
+         complement.resize( 0 ) ;
+
+         for( int i = 0, m = 0 ; i < tree.nbItems() ; i++ )
+         {
+              while( m < itemset.size() && itemset[ m ] < tree.item( i ) )
+                     m++ ;
+
+              if( m == itemset.size() || itemset[ m ] != tree.item( i ) )
+                  complement.push_back( tree.item( i ) ) ;
+         }
+
+         if( complement.size() )
+             complements.insert( &complement ) ;
+    }
+
+    MinTransversals< SetsType, Measure > minTransversals ;
+    minTransversals.nbThreads = nbTransversalThreads ;
+
+    Cand_DataStruct * transv = minTransversals( complements, 1, maximals.length() + 1 ) ;
+
+    complements.release() ;
+
+    for( typename Cand_DataStruct::iterator it = transv->beginLeaf() ; it != transv->end() ; it = it.nextLeaf() )
+         bdN->push_back( * it, Measure( false, tree.count( * it.getInternalset() ) ) ) ;
+
+    if( this->verbose ) cout<<"Bd-: "<<transv->size()<<" ["<<(clock()-start)/CLOCKS_PER_SEC<<"s]"<<endl;
+
+    delete transv ;
+}
+
+#endif
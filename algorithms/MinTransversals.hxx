@@ -0,0 +1,421 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef MINTRANSVERSALS_HXX
+#define MINTRANSVERSALS_HXX
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+#include "PTree.hxx"
+
+using namespace std;
+
+//! Functor computing the minimal transversals of an hypergraph stored in a trie, with the algorithm MMCS (Murakami and Uno).
+/**
+   The edges and the sets of edges are stored in bitsets.
+   The minimal transversals are enumerated by a depth first search: at each step, an edge not already intersected is chosen
+   (the one with the fewest candidate items) and the current set is extended with each of its candidate items.
+   A set is extended only if each of its items is the only one of the set intersecting an edge (the "critical" edges of the item),
+   so that each minimal transversal is found once, without any inclusion test.
+
+   As PTree::trMinOpt( minEdge, maxTrans ), only the minimal transversals of size <= maxTrans
+   of the edges of size >= minEdge are computed.
+
+   The branches of the search are independent. With several threads, the first steps of the search are executed
+   to obtain enough branches, and then the branches are shared between the threads.
+
+   The template parameter SetsType is the type of the elements.
+   The template parameter T is the type of the measure of the tries.
+*/
+template< class SetsType, class T >
+class MinTransversals
+{
+        //! Type of the words of the bitsets
+        typedef unsigned long long Word ;
+
+        //! Type of a bitset
+        typedef vector< Word > Bitset ;
+
+        //! Number of bits in a word
+        static const int wordSize = 8 * sizeof( Word ) ;
+
+        //! A step of the search
+        struct State
+        {
+            //! the items of the current set (index of the items)
+            vector< int > items ;
+
+            //! the items which can extend the current set
+            Bitset cand ;
+
+            //! the edges not intersected by the current set
+            Bitset uncov ;
+
+            //! the critical edges of each item of the current set
+            vector< Bitset > crit ;
+        };
+
+        //! Functor executed by each thread
+        /**
+            The threads take the next branch not already processed until there is no more branch.
+        */
+        class searchThread
+        {
+                MinTransversals * tr ;
+
+                //! the branches
+                vector< State > * tasks ;
+
+                //! minimal transversals found by the thread
+                vector< vectUI > * result ;
+
+                //! next branch to process
+                atomic<int> * next ;
+
+            public:
+
+                searchThread( MinTransversals * intr, vector< State > * intasks, vector< vectUI > * inresult, atomic<int> * innext )
+                {
+                    tr = intr ; tasks = intasks ; result = inresult ; next = innext ;
+                }
+
+                void operator()()
+                {
+                     int task ;
+                     while( ( task = next->fetch_add( 1 ) ) < (int) tasks->size() )
+                          tr->search( (*tasks)[ task ], 0, *result ) ;
+                }
+        };
+
+        //! the items of the edges (internal id), in increasing order
+        vector< int > items ;
+
+        //! the edges
+        vector< Bitset > edges ;
+
+        //! the edges containing each item
+        vector< Bitset > occ ;
+
+        //! maximum size of the minimal transversals
+        int maxTrans ;
+
+        //! Return true if a bitset is empty
+        static bool empty( const Bitset & b )
+        {
+            for( int w = 0 ; w < (int) b.size() ; w++ )
+                 if( b[ w ] )
+                     return false ;
+            return true ;
+        }
+
+        //! Return the number of bits set in a word
+        static int popcount( Word w )
+        {
+            #ifdef __GNUC__
+            return __builtin_popcountll( w ) ;
+            #else
+            int nb = 0 ;
+            for( ; w ; nb++ ) w &= w - 1 ;
+            return nb ;
+            #endif
+        }
+
+        //! Return the index of the first bit set in a word (not null)
+        static int firstBit( Word w )
+        {
+            #ifdef __GNUC__
+            return __builtin_ctzll( w ) ;
+            #else
+            int i = 0 ;
+            for( ; ! ( w & 1 ) ; i++ ) w >>= 1 ;
+            return i ;
+            #endif
+        }
+
+        //! Read the edges of size >= minEdge of a trie
+        /**
+            \param currNode current node of the trie
+            \param minEdge minimum size of the edges
+            \param vect the items of the current node
+            \param sets the edges read
+        */
+        void readEdges( Node< SetsType, T > * currNode, int minEdge, vectUI & vect, vector< vectUI > & sets ) ;
+
+        //! Execute a step of the search
+        /**
+            \param st the current step
+            \param children if not 0, the next steps are stored in it (else they are executed)
+            \param result the minimal transversals found
+        */
+        void search( State & st, vector< State > * children, vector< vectUI > & result ) ;
+
+    public:
+
+        //! Number of threads used to enumerate the minimal transversals (1 by default, ie no thread)
+        int nbThreads ;
+
+        //! Constructor
+        MinTransversals(){ nbThreads = 1 ; maxTrans = 0 ; }
+
+        //! Compute the minimal transversals of a set of sets
+        /**
+            \param hypergraph the sets (the edges)
+            \param minEdge only the edges of size >= minEdge are considered
+            \param inMaxTrans only the minimal transversals of size <= maxTrans are computed
+            \return a new trie storing the minimal transversals (with the recode functor of the hypergraph)
+        */
+        PTree< SetsType, T > * operator()( PTree< SetsType, T > & hypergraph, int minEdge, int inMaxTrans ) ;
+};
+
+//! Read the edges of size >= minEdge of a trie
+/**
+    \param currNode current node of the trie
+    \param minEdge minimum size of the edges
+    \param vect the items of the current node
+    \param sets the edges read
+*/
+template< class SetsType, class T >
+void MinTransversals< SetsType, T >::readEdges( Node< SetsType, T > * currNode, int minEdge, vectUI & vect, vector< vectUI > & sets )
+{
+    for( int i = 0; currNode->getCnts() && i < currNode->getCnts()->size(); i++ )
+    {
+        if( currNode->existVal( i ) )
+        {
+            vect.push_back( i + currNode->getOffset() ) ;
+
+            if( currNode->getChilds() && i < currNode->getChilds()->size() && (* currNode->getChilds() )[ i ] )
+                readEdges( (* currNode->getChilds() )[ i ], minEdge, vect, sets ) ;
+            else if( vect.size() >= minEdge )
+                sets.push_back( vect ) ;
+
+            vect.pop_back() ;
+        }
+    }
+}
+
+//! Compute the minimal transversals of a set of sets
+/**
+    \param hypergraph the sets (the edges)
+    \param minEdge only the edges of size >= minEdge are considered
+    \param inMaxTrans only the minimal transversals of size <= maxTrans are computed
+    \return a new trie storing the minimal transversals (with the recode functor of the hypergraph)
+*/
+template< class SetsType, class T >
+PTree< SetsType, T > * MinTransversals< SetsType, T >::operator()( PTree< SetsType, T > & hypergraph, int minEdge, int inMaxTrans )
+{
+    PTree< SetsType, T > * res = new PTree< SetsType, T >( 0, 0, 0, hypergraph.recode ) ;
+
+    maxTrans = inMaxTrans ;
+
+    vector< vectUI > sets ;
+    vectUI vect ;
+
+    if( hypergraph.getHead() )
+        readEdges( hypergraph.getHead(), minEdge, vect, sets ) ;
+
+    if( sets.empty() )
+        return res ;
+
+    // index of the items
+    int maxId = 0 ;
+    for( int e = 0 ; e < sets.size() ; e++ )
+         if( sets[ e ].back() > maxId )
+             maxId = sets[ e ].back() ;
+
+    vector< int > index( maxId + 1, -1 ) ;
+    for( int e = 0 ; e < sets.size() ; e++ )
+         for( int i = 0 ; i < sets[ e ].size() ; i++ )
+              index[ sets[ e ][ i ] ] = 0 ;
+
+    items.resize( 0 ) ;
+    for( int id = 0 ; id <= maxId ; id++ )
+         if( index[ id ] == 0 )
+         {
+             index[ id ] = items.size() ;
+             items.push_back( id ) ;
+         }
+
+    int nbItemWords = ( items.size() + wordSize - 1 ) / wordSize ;
+    int nbEdgeWords = ( sets.size() + wordSize - 1 ) / wordSize ;
+
+    edges.assign( sets.size(), Bitset( nbItemWords, 0 ) ) ;
+    occ.assign( items.size(), Bitset( nbEdgeWords, 0 ) ) ;
+
+    for( int e = 0 ; e < sets.size() ; e++ )
+         for( int i = 0 ; i < sets[ e ].size() ; i++ )
+         {
+              int item = index[ sets[ e ][ i ] ] ;
+              edges[ e ][ item / wordSize ] |= ( (Word) 1 ) << ( item % wordSize ) ;
+              occ[ item ][ e / wordSize ] |= ( (Word) 1 ) << ( e % wordSize ) ;
+         }
+
+    // the first step: the empty set, all the items are candidates and no edge is intersected
+    State root ;
+    root.cand.assign( nbItemWords, ~( (Word) 0 ) ) ;
+    root.uncov.assign( nbEdgeWords, ~( (Word) 0 ) ) ;
+    if( items.size() % wordSize )
+        root.cand.back() = ( ( (Word) 1 ) << ( items.size() % wordSize ) ) - 1 ;
+    if( sets.size() % wordSize )
+        root.uncov.back() = ( ( (Word) 1 ) << ( sets.size() % wordSize ) ) - 1 ;
+
+    vector< vectUI > result ;
+
+    if( nbThreads > 1 )
+    {
+        // execute the first steps until there are enough branches for the threads
+        vector< State > tasks( 1, root ) ;
+        vector< State > children ;
+
+        while( tasks.size() && tasks.size() < nbThreads * 16 )
+        {
+            children.resize( 0 ) ;
+            for( int t = 0 ; t < tasks.size() ; t++ )
+                 search( tasks[ t ], &children, result ) ;
+            tasks.swap( children ) ;
+        }
+
+        vector< vector< vectUI > > results( nbThreads ) ;
+        atomic<int> next( 0 ) ;
+        vector< thread > threads ;
+
+        for( int t = 0 ; t < nbThreads ; t++ )
+             threads.push_back( thread( searchThread( this, &tasks, &results[ t ], &next ) ) ) ;
+
+        for( int t = 0 ; t < nbThreads ; t++ )
+        {
+             threads[ t ].join() ;
+             result.insert( result.end(), results[ t ].begin(), results[ t ].end() ) ;
+        }
+    }
+    else
+        search( root, 0, result ) ;
+
+    for( int r = 0 ; r < result.size() ; r++ )
+         res->insert( &result[ r ] ) ;
+
+    return res ;
+}
+
+//! Execute a step of the search
+/**
+    \param st the current step
+    \param children if not 0, the next steps are stored in it (else they are executed)
+    \param result the minimal transversals found
+*/
+template< class SetsType, class T >
+void MinTransversals< SetsType, T >::search( State & st, vector< State > * children, vector< vectUI > & result )
+{
+    if( empty( st.uncov ) ) // the current set is a minimal transversal
+    {
+        vectUI trans( st.items.size() ) ;
+        for( int i = 0 ; i < st.items.size() ; i++ )
+             trans[ i ] = items[ st.items[ i ] ] ;
+        sort( trans.begin(), trans.end() ) ;
+        result.push_back( trans ) ;
+        return ;
+    }
+
+    if( st.items.size() >= maxTrans )
+        return ;
+
+    // choose the edge not intersected with the fewest candidate items
+    int chosen = -1 ;
+    int minCand = 0 ;
+
+    for( int w = 0 ; w < st.uncov.size() ; w++ )
+    {
+        for( Word bits = st.uncov[ w ] ; bits ; bits &= bits - 1 )
+        {
+            int e = w * wordSize + firstBit( bits ) ;
+
+            int nb = 0 ;
+            for( int i = 0 ; i < st.cand.size() ; i++ )
+                 nb += popcount( st.cand[ i ] & edges[ e ][ i ] ) ;
+
+            if( chosen == -1 || nb < minCand )
+            {
+                chosen = e ;
+                minCand = nb ;
+            }
+        }
+    }
+
+    if( minCand == 0 ) // the edge cannot be intersected
+        return ;
+
+    // the candidate items of the edge are removed from the candidates,
+    // and each one is added back after its branch
+    Bitset branchItems( st.cand.size() ) ;
+    Bitset cand = st.cand ;
+    for( int i = 0 ; i < cand.size() ; i++ )
+    {
+         branchItems[ i ] = cand[ i ] & edges[ chosen ][ i ] ;
+         cand[ i ] &= ~branchItems[ i ] ;
+    }
+
+    State child ;
+
+    for( int w = 0 ; w < branchItems.size() ; w++ )
+    {
+        for( Word bits = branchItems[ w ] ; bits ; bits &= bits - 1 )
+        {
+            int item = w * wordSize + firstBit( bits ) ;
+            const Bitset & occItem = occ[ item ] ;
+
+            // the critical edges of the items of the current set which are not intersected by the new item
+            bool minimal = true ;
+            child.crit.resize( st.items.size() + 1 ) ;
+            for( int j = 0 ; j < st.items.size() && minimal ; j++ )
+            {
+                 child.crit[ j ].resize( occItem.size() ) ;
+                 for( int i = 0 ; i < occItem.size() ; i++ )
+                      child.crit[ j ][ i ] = st.crit[ j ][ i ] & ~occItem[ i ] ;
+                 minimal = ! empty( child.crit[ j ] ) ;
+            }
+
+            if( minimal )
+            {
+                child.crit.back().resize( occItem.size() ) ;
+                child.uncov.resize( occItem.size() ) ;
+                for( int i = 0 ; i < occItem.size() ; i++ )
+                {
+                     child.crit.back()[ i ] = st.uncov[ i ] & occItem[ i ] ;
+                     child.uncov[ i ] = st.uncov[ i ] & ~occItem[ i ] ;
+                }
+
+                child.items = st.items ;
+                child.items.push_back( item ) ;
+                child.cand = cand ;
+
+                if( children )
+                    children->push_back( child ) ;
+                else
+                    search( child, 0, result ) ;
+            }
+
+            cand[ w ] |= ( (Word) 1 ) << ( item % wordSize ) ;
+        }
+    }
+}
+
+#endif
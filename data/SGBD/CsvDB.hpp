@@ -0,0 +1,327 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef CSV_DB_HPP
+#define CSV_DB_HPP
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// Class that represents a relation/table stored in a csv file
+class Csv_rel
+{
+ public:
+
+      //! Constructor
+      /*!
+            \param inName name of the relation/table, ie the name of the file
+
+            The first line of the file contains the attributes, and each other line a tuple (the values are separated by ";").
+      */
+      Csv_rel( char * inName )
+      {
+        name = inName ;
+
+        ifstream file( inName ) ;
+        string line ;
+
+        if( ! getline( file, line ) )
+        {
+             cerr<<"Error when selecting the relation "<<name<<endl;
+             return ;
+        }
+
+        split( line, ';', attributes ) ;
+
+        while( getline( file, line ) )
+               if( line.size() )
+               {
+                   tuples.push_back( vector<string>() ) ;
+                   split( line, ';', tuples.back() ) ;
+                   tuples.back().resize( attributes.size() ) ;
+               }
+      }
+
+      //! Split a character string
+      /*!
+          \param str the character string
+          \param sep the separator
+          \param values stores the values (the spaces around the values are removed)
+      */
+      static void split( const string & str, char sep, vector<string> & values )
+      {
+            istringstream in( str ) ;
+            string value ;
+
+            while( getline( in, value, sep ) )
+            {
+                   string::size_type first = value.find_first_not_of( " \r" ) ;
+                   string::size_type last = value.find_last_not_of( " \r" ) ;
+                   values.push_back( first == string::npos ? string() : value.substr( first, last - first + 1 ) ) ;
+            }
+      }
+
+      //! Return the number of an attribute (-1 if it is not an attribute of the relation)
+      int number( const string & attribute )
+      {
+            vector<string>::iterator it = find( attributes.begin(), attributes.end(), attribute ) ;
+            return it == attributes.end() ? -1 : it - attributes.begin() ;
+      }
+
+      //! Name of the relation
+      string name;
+
+      //! List of all the attributes.
+      vector<string> attributes;
+
+      //! The tuples of the relation
+      vector< vector<string> > tuples;
+};
+
+
+
+// Class that simulates a database with relations stored in csv files
+/*!
+    This class has the same interface than Mysql_db, but only knows the queries used by the predicates on INDs
+    (see SatisfiedIND_DBMS):
+        * select count(*) from r1 where ( a1,... ) not in( SELECT distinct b1,... FROM r2 )
+        * select concat( exists( select * from r1 where ( a1,... ) not in( SELECT distinct b1,... FROM r2 ) ), ... )
+        * select a1,... from r1
+
+    It can be used to test the programs using a DBMS without a database server.
+    The number of queries executed is counted (nbQueries).
+*/
+class Csv_db
+{
+      typedef map< string, Csv_rel >   mapRel;
+      typedef map< string, Csv_rel >::iterator  mapRelIt;
+
+ protected:
+
+      //! List of the  already selected relations.
+      mapRel selRelations;
+
+      //! Vector used to store the ordering of selection of the tables (the first selection of each relation)
+      vector< Csv_rel *> order_selRel ;
+
+      //! Query stored
+      string query;
+
+      //! Return the selected relation of a name (0 if it is not selected)
+      Csv_rel * relation( const string & name )
+      {
+            mapRelIt it = selRelations.find( name ) ;
+            return it == selRelations.end() ? 0 : &( it->second ) ;
+      }
+
+      //! Return the numbers of a list of attributes, separated by ",", of a relation
+      /*!
+          \return false if a relation or an attribute is unknown
+      */
+      bool numbers( Csv_rel * rel, const string & attribs, vector<int> & num )
+      {
+            if( ! rel )
+                return false ;
+
+            vector<string> names ;
+            Csv_rel::split( attribs, ',', names ) ;
+
+            for( vector<string>::iterator it = names.begin() ; it != names.end() ; ++it )
+            {
+                 num.push_back( rel->number( *it ) ) ;
+                 if( num.back() < 0 )
+                     return false ;
+            }
+
+            return true ;
+      }
+
+      //! Count the tuples of r1 whose projection is not in the projection of r2 ( "from r1 where ( a1,... ) not in( SELECT distinct b1,... FROM r2 )" )
+      /*!
+          \param pos position of the "from" in the query, set after the part of the query read.
+          \return the number of tuples, or -1 if the query is not known
+      */
+      int notIn( string::size_type & pos )
+      {
+            string::size_type where = query.find( " where ( ", pos ) ;
+            string::size_type notin = where == string::npos ? where : query.find( " ) not in( SELECT distinct ", where ) ;
+            string::size_type from = notin == string::npos ? notin : query.find( " FROM ", notin ) ;
+            string::size_type end = from == string::npos ? from : query.find( " )", from + 6 ) ;
+
+            if( end == string::npos )
+                return -1 ;
+
+            Csv_rel * rel1 = relation( query.substr( pos + 5, where - pos - 5 ) ) ;
+            Csv_rel * rel2 = relation( query.substr( from + 6, end - from - 6 ) ) ;
+            vector<int> left, right ;
+
+            if( ! numbers( rel1, query.substr( where + 9, notin - where - 9 ), left ) || ! numbers( rel2, query.substr( notin + 27, from - notin - 27 ), right ) || left.size() != right.size() )
+                return -1 ;
+
+            pos = end + 2 ;
+
+            set< vector<string> > projection ;
+            vector<string> tuple( right.size() ) ;
+
+            for( vector< vector<string> >::iterator it = rel2->tuples.begin() ; it != rel2->tuples.end() ; ++it )
+            {
+                 for( int i = 0 ; i < right.size() ; i++ )
+                      tuple[ i ] = (*it)[ right[ i ] ] ;
+                 projection.insert( tuple ) ;
+            }
+
+            int nb = 0 ;
+            for( vector< vector<string> >::iterator it = rel1->tuples.begin() ; it != rel1->tuples.end() ; ++it )
+            {
+                 for( int i = 0 ; i < left.size() ; i++ )
+                      tuple[ i ] = (*it)[ left[ i ] ] ;
+                 if( ! projection.count( tuple ) )
+                     nb++ ;
+            }
+
+            return nb ;
+      }
+
+ public:
+
+      //! Number of queries executed
+      int nbQueries ;
+
+      //! Constructor
+      Csv_db(){ nbQueries = 0 ; }
+
+      //! Get the stored query
+      string & get_query(){ return query ;}
+
+      //! Select a relation/table in the database
+      /*!
+          \param relation_name name of the file containing the relation/table to select.
+          \return the selected relation.
+      */
+      Csv_rel & select_relation( char * relation_name )
+      {
+            mapRelIt it = selRelations.find( relation_name ) ;
+
+            if( it == selRelations.end() )  // if not already selected store this relation
+            {
+                it = selRelations.insert( mapRel::value_type( relation_name, Csv_rel( relation_name ) ) ).first ;
+                order_selRel.push_back( &(it->second) ); // store the order of the selected realtion
+            }
+
+            return  it->second;
+      }
+
+      //! Get a pointer on the ith selected relation
+      Csv_rel * get_relation( int i )
+      {
+                i = i -1;
+                if( i < 0 || i >= order_selRel.size() ) return 0;
+                return order_selRel[i] ;
+      }
+
+      //! Store a query
+      void store_query( char * inQuery  ) { query = inQuery; }
+
+      //! Replace some part of the query by another character string (see Mysql_db)
+      void replace_in_query( char * old_string, char * new_string)
+      {
+           string::size_type pos = 0; // current position in character string
+
+           string oldstr = old_string;
+           string newstr = new_string ;
+
+           while( (pos = query.find(oldstr, pos+1 ) ) != string::npos)
+                  query.replace( pos, oldstr.size(), newstr);
+      }
+
+      //! Execute the stored query (works only if the query returns an unique value).
+      /*!
+          \return the result value of the query (an empty string if the query is not known)
+      */
+      string exec_query()
+      {
+            nbQueries++ ;
+
+            ostringstream res ;
+            string::size_type pos = query.find( "from " ) ;
+
+            if( query.compare( 0, 16, "select count(*) " ) == 0 && pos != string::npos )
+            {
+                int nb = notIn( pos ) ;
+                if( nb >= 0 )
+                    res<<nb ;
+            }
+            else if( query.compare( 0, 15, "select concat( " ) == 0 )
+            {
+                // one character for each "exists": 1 if there are tuples not in the second relation, 0 otherwise
+                for( ; pos != string::npos ; pos = query.find( "from ", pos ) )
+                {
+                     int nb = notIn( pos ) ;
+                     if( nb < 0 )
+                         return string() ;
+                     res<<( nb ? '1' : '0' ) ;
+                }
+            }
+
+            if( res.str().empty() )
+                cerr<<"Unknown query: "<<query<<endl ;
+
+            return res.str() ;
+      }
+
+      //! Execute the stored query ( "select a1,... from r1" ) and store all the rows of the result.
+      /*!
+          \param rows stores the rows of the result
+          \return false if the query cannot be executed
+      */
+      bool exec_query( vector< vector<string> > & rows )
+      {
+            nbQueries++ ;
+
+            string::size_type from = query.find( " from " ) ;
+            vector<int> num ;
+            Csv_rel * rel = from == string::npos ? 0 : relation( query.substr( from + 6 ) ) ;
+
+            if( query.compare( 0, 7, "select " ) != 0 || ! numbers( rel, query.substr( 7, from - 7 ), num ) )
+            {
+                cerr<<"Unknown query: "<<query<<endl ;
+                return false ;
+            }
+
+            for( vector< vector<string> >::iterator it = rel->tuples.begin() ; it != rel->tuples.end() ; ++it )
+            {
+                 rows.push_back( vector<string>( num.size() ) ) ;
+                 for( int i = 0 ; i < num.size() ; i++ )
+                      rows.back()[ i ] = (*it)[ num[ i ] ] ;
+            }
+
+            return true ;
+      }
+
+};
+#endif
@@ -184,7 +184,7 @@ class Mysql_db
       */
       void replace_in_query( char * old_string, char * new_string)
       {           
-           unsigned int pos = 0; // current position in character string
+           string::size_type pos = 0; // current position in character string
            
            string oldstr = old_string;
            string newstr = new_string ;
@@ -220,6 +220,38 @@ class Mysql_db
                
       }
       
+      //! Execute the stored query and store all the rows of the result.
+      /*!
+          \param rows stores the rows of the result (the NULL values are stored as empty strings)
+          \return false if the query cannot be executed
+      */
+      bool exec_query( vector< vector<string> > & rows )
+      {
+            MYSQL_RES *result;
+            MYSQL_ROW row;   
+            
+            if( mysql_query( &mysql, query.c_str() ) ) // execute the query
+                return false ;
+
+            result = mysql_use_result(&mysql); 
+            if( ! result )
+                return false ;
+            
+            unsigned int nbFields = mysql_num_fields( result ) ;
+            
+            while( row = mysql_fetch_row(result) ) // get each row of the result
+            {
+                   rows.push_back( vector<string>( nbFields ) ) ;
+                   for( unsigned int i = 0 ; i < nbFields ; i++ )
+                        if( row[i] )
+                            rows.back()[i] = row[i] ;
+            }
+                         
+            mysql_free_result( result );  
+            
+            return true ;
+      }
+      
     
       
       
@@ -0,0 +1,346 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef DBCACHE_HXX
+#define DBCACHE_HXX
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <unordered_map>
+
+#include "MappedFile.hxx"
+
+using namespace std;
+
+//! Class representing a binary file storing a preprocessed transactionnal db (cache of the db).
+/**
+    The cache stores the result of the preprocessing of the db:
+    the items in increasing order of support with their support (the dictionary),
+    and the transactions recoded with the internal ids of the items (position of the item in the dictionary) and sorted.
+    All the items are stored, so the same cache can be used for any minimum support threshold.
+
+    The cache is mapped in memory when it is loaded, the items and the transactions are read directly in the mapped file.
+    It is associated to a source file (the file in the FIMI format), and it is not loaded if the size or the checksum
+    of the source file have changed since the cache was saved.
+
+    Format of the file (in the byte order of the machine):
+    a header, the items, their supports, the position of the first item of each transaction and the items of the transactions.
+    Each part begins at a position multiple of 8.
+
+    The template parameter SetsType is the type of the items (it must be copied byte by byte, as int).
+    \see BinaryDB
+*/
+template< class SetsType=int >
+class DBCache
+{
+    protected:
+
+        //! Header of the file
+        struct Header
+        {
+            //! used to recognize the file and its version
+            char magic[ 8 ] ;
+
+            //! size of the source file
+            unsigned long long sourceSize ;
+
+            //! checksum of the source file
+            unsigned long long checksum ;
+
+            //! size of an item (sizeof(SetsType))
+            int itemSize ;
+
+            //! number of items
+            int nbItems ;
+
+            //! number of transactions
+            int nbTrans ;
+
+            int unused ;
+
+            //! number of items in all the transactions
+            unsigned long long nbValues ;
+        };
+
+        //! name of the source file
+        string sourceFile ;
+
+        //! name of the cache
+        string cacheFile ;
+
+        //! the cache mapped in memory
+        MappedFile file ;
+
+        //! Header of the cache loaded (0 if the cache is not loaded)
+        const Header * header ;
+
+        //! items of the dictionary
+        const SetsType * items ;
+
+        //! supports of the items
+        const int * supports ;
+
+        //! position of the first item of each transaction (and of the end of the last transaction)
+        const unsigned long long * offsets ;
+
+        //! items of the transactions
+        const int * values ;
+
+        //! Return the size of a part of the file (rounded to the next multiple of 8)
+        static size_t align( size_t size ){ return ( size + 7 ) / 8 * 8 ; }
+
+        //! Write a part of the file (completed by zeros up to a multiple of 8)
+        static bool write( FILE * out, const void * part, size_t size ) ;
+
+    public:
+
+        //! Constructor.
+        /**
+            \param inSourceFile name of the source file
+            \param inCacheFile name of the cache (by default, the name of the source file followed by ".cache")
+        */
+        DBCache( const char * inSourceFile, const char * inCacheFile = 0 )
+        {
+            sourceFile = inSourceFile ;
+            cacheFile = inCacheFile ? string( inCacheFile ) : sourceFile + ".cache" ;
+            header = 0 ; items = 0 ; supports = 0 ; offsets = 0 ; values = 0 ;
+        }
+
+        //! Destructor.
+        ~DBCache(){ close() ; }
+
+        //! Compute the checksum of a file (FNV-1a on 64 bits)
+        /**
+            \param fileName name of the file
+            \param size the size of the file
+            \return the checksum (0 if the file cannot be read)
+        */
+        static unsigned long long checksum( const char * fileName, unsigned long long & size ) ;
+
+        //! Load the cache
+        /**
+            \return false if the cache does not exist or does not correspond to the source file
+        */
+        bool load() ;
+
+        //! Unload the cache
+        void close(){ file.close() ; header = 0 ; items = 0 ; supports = 0 ; offsets = 0 ; values = 0 ; }
+
+        //! Return true if the cache is loaded
+        bool loaded() const { return header != 0 ; }
+
+        //! Save a db in the cache
+        /**
+            The template parameter ListItemSupp is a container of pairs (item, support) in increasing order of support.
+            The template parameter Transactions is a container of transactions (containers of items).
+            \param listItems the items of the db with their support
+            \param transactions the transactions of the db (not recoded)
+            \return false if the cache cannot be written
+        */
+        template< class ListItemSupp, class Transactions >
+        bool save( ListItemSupp & listItems, Transactions & transactions ) ;
+
+        //! Return the number of items
+        int nbItems() const { return header->nbItems ; }
+
+        //! Return the i-th item of the dictionary (in increasing order of support)
+        SetsType item( int i ) const { return items[ i ] ; }
+
+        //! Return the support of the i-th item of the dictionary
+        int support( int i ) const { return supports[ i ] ; }
+
+        //! Return the number of transactions
+        int nbTransactions() const { return header->nbTrans ; }
+
+        //! Return a pointer on the first item of the t-th transaction (internal ids in increasing order)
+        const int * begin( int t ) const { return values + offsets[ t ] ; }
+
+        //! Return a pointer after the last item of the t-th transaction
+        const int * end( int t ) const { return values + offsets[ t + 1 ] ; }
+};
+
+//! Identifier of the format (and of its version)
+static const char dbCacheMagic[ 8 ] = { 'i', 'Z', 'i', 'D', 'B', 'C', '1', 0 } ;
+
+//! Compute the checksum of a file (FNV-1a on 64 bits)
+template< class SetsType >
+unsigned long long DBCache< SetsType >::checksum( const char * fileName, unsigned long long & size )
+{
+    MappedFile source ;
+    size = 0 ;
+
+    if( ! source.open( fileName ) )
+        return 0 ;
+
+    const unsigned char * p = (const unsigned char *) source.data() ;
+    const unsigned char * last = p + source.size() ;
+    unsigned long long hash = 14695981039346656037ULL ;
+
+    for( ; p < last ; ++p )
+    {
+        hash ^= *p ;
+        hash *= 1099511628211ULL ;
+    }
+
+    size = source.size() ;
+
+    return hash ;
+}
+
+//! Load the cache
+template< class SetsType >
+bool DBCache< SetsType >::load()
+{
+    close() ;
+
+    if( ! file.open( cacheFile.c_str(), false ) || file.size() < sizeof( Header ) )
+    {
+        file.close() ;
+        return false ;
+    }
+
+    const Header * head = (const Header *) file.data() ;
+
+    // check the format
+    if( memcmp( head->magic, dbCacheMagic, 8 ) || head->itemSize != sizeof( SetsType ) || head->nbItems < 0 || head->nbTrans < 0 )
+    {
+        file.close() ;
+        return false ;
+    }
+
+    size_t itemsPos = align( sizeof( Header ) ) ;
+    size_t supportsPos = itemsPos + align( head->nbItems * sizeof( SetsType ) ) ;
+    size_t offsetsPos = supportsPos + align( head->nbItems * sizeof( int ) ) ;
+    size_t valuesPos = offsetsPos + align( ( head->nbTrans + 1 ) * sizeof( unsigned long long ) ) ;
+
+    if( file.size() < valuesPos + head->nbValues * sizeof( int ) )
+    {
+        file.close() ;
+        return false ;
+    }
+
+    // check that the source file has not changed
+    unsigned long long size ;
+    unsigned long long sum = checksum( sourceFile.c_str(), size ) ;
+
+    if( size != head->sourceSize || sum != head->checksum )
+    {
+        file.close() ;
+        return false ;
+    }
+
+    header = head ;
+    items = (const SetsType *) ( file.data() + itemsPos ) ;
+    supports = (const int *) ( file.data() + supportsPos ) ;
+    offsets = (const unsigned long long *) ( file.data() + offsetsPos ) ;
+    values = (const int *) ( file.data() + valuesPos ) ;
+
+    return true ;
+}
+
+//! Write a part of the file (completed by zeros up to a multiple of 8)
+template< class SetsType >
+bool DBCache< SetsType >::write( FILE * out, const void * part, size_t size )
+{
+    static const char zeros[ 8 ] = { 0 } ;
+
+    if( size && fwrite( part, 1, size, out ) != size )
+        return false ;
+
+    size_t padding = align( size ) - size ;
+
+    return ! padding || fwrite( zeros, 1, padding, out ) == padding ;
+}
+
+//! Save a db in the cache
+template< class SetsType > template< class ListItemSupp, class Transactions >
+bool DBCache< SetsType >::save( ListItemSupp & listItems, Transactions & transactions )
+{
+    close() ;
+
+    Header head ;
+    memset( &head, 0, sizeof( Header ) ) ;
+    memcpy( head.magic, dbCacheMagic, 8 ) ;
+    head.checksum = checksum( sourceFile.c_str(), head.sourceSize ) ;
+    head.itemSize = sizeof( SetsType ) ;
+
+    // the dictionary: the internal id of an item is its position
+    vector< SetsType > dictItems ;
+    vector< int > dictSupports ;
+    unordered_map< SetsType, int > internalIds ;
+
+    for( typename ListItemSupp::iterator it = listItems.begin() ; it != listItems.end() ; ++it )
+    {
+        internalIds[ it->first ] = dictItems.size() ;
+        dictItems.push_back( it->first ) ;
+        dictSupports.push_back( it->second ) ;
+    }
+    head.nbItems = dictItems.size() ;
+
+    // position of the transactions
+    vector< unsigned long long > transOffsets ;
+    transOffsets.reserve( transactions.size() + 1 ) ;
+    transOffsets.push_back( 0 ) ;
+    for( typename Transactions::iterator it = transactions.begin() ; it != transactions.end() ; ++it )
+        transOffsets.push_back( transOffsets.back() + it->size() ) ;
+    head.nbTrans = transactions.size() ;
+    head.nbValues = transOffsets.back() ;
+
+    // the cache is written in a temporary file, renamed at the end (a cache is never partially written)
+    string tmpFile = cacheFile + ".tmp" ;
+    FILE * out = fopen( tmpFile.c_str(), "wb" ) ;
+    if( ! out )
+        return false ;
+
+    bool ok = write( out, &head, sizeof( Header ) )
+              && write( out, dictItems.size() ? &dictItems[ 0 ] : 0, dictItems.size() * sizeof( SetsType ) )
+              && write( out, dictSupports.size() ? &dictSupports[ 0 ] : 0, dictSupports.size() * sizeof( int ) )
+              && write( out, &transOffsets[ 0 ], transOffsets.size() * sizeof( unsigned long long ) ) ;
+
+    // the transactions are recoded and sorted
+    vector< int > trans ;
+    for( typename Transactions::iterator it = transactions.begin() ; ok && it != transactions.end() ; ++it )
+    {
+        trans.resize( 0 ) ;
+        for( typename Transactions::value_type::iterator itItem = it->begin() ; itItem != it->end() ; ++itItem )
+            trans.push_back( internalIds[ *itItem ] ) ;
+        sort( trans.begin(), trans.end() ) ;
+
+        ok = trans.empty() || fwrite( &trans[ 0 ], sizeof( int ), trans.size(), out ) == trans.size() ;
+    }
+
+    ok = ( fclose( out ) == 0 ) && ok ;
+
+    if( ok )
+        remove( cacheFile.c_str() ) ; // the old cache (rename does not replace a file on all the systems)
+
+    if( ! ok || rename( tmpFile.c_str(), cacheFile.c_str() ) )
+    {
+        remove( tmpFile.c_str() ) ;
+        return false ;
+    }
+
+    return true ;
+}
+
+#endif
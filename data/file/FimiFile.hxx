@@ -86,7 +86,6 @@ class FimiFile
                  template< class T >     
                  void operator() (T & x) { 
                       (*f)<<x<<" ";  
-                      f->flush();                                        
                  }
         };
         
@@ -0,0 +1,489 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FIMIFILEBUFFERED_HXX
+#define FIMIFILEBUFFERED_HXX
+
+#include <vector>
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+//! Return the value written in a file for a measure (the measure itself by default)
+/**
+    It can be overloaded for a measure type to write it as an integer (see Support),
+    so that it is formatted by FimiFileBuffered without the iostream library.
+*/
+template< class T >
+inline const T & outputValue( const T & val ){ return val ; }
+
+//! Class used to save data in the FIMI format with large buffers (output only).
+/**
+    It has the same output functions than FimiFile (push_back and operator <<) and writes the same lines,
+    so it can be used instead of FimiFile to save the theory or the borders found by an algorithm.
+
+    The lines are formatted in a large buffer (the integers are converted without the iostream library)
+    and the buffer is written in the file with one fwrite when it is full.
+    The measures are formatted as integers if outputValue() returns an integer for them,
+    else with their operator <<.
+
+    Optionally, the buffers are written by a background thread:
+    when a buffer is full it is passed to the thread and the algorithm continues in another buffer.
+    The number of buffers waiting to be written is limited (the algorithm waits if the thread is too slow).
+
+    The file is opened at the first write and closed by close() or the destructor.
+    If the file cannot be opened, the error is printed once and the data written is ignored.
+    The template parameter SetsType is the type of items in the itemsets.
+*/
+template< class SetsType=int >
+class FimiFileBuffered
+{
+    protected:
+
+        //! Functor executed by the background thread
+        class writer
+        {
+                FimiFileBuffered * file ;
+
+            public:
+
+                writer( FimiFileBuffered * infile ){ file = infile ; }
+
+                void operator()(){ file->writeBuffers() ; }
+        };
+
+        //! name of the file to used
+        const char * fileName ;
+
+        //! the file (0 if the file is not open)
+        FILE * writefile ;
+
+        //! True if the file cannot be opened (the error is reported once and the data is ignored)
+        bool error ;
+
+        //! Size of the buffers
+        size_t bufferSize ;
+
+        //! Buffer where the lines are formatted
+        vector< char > buffer ;
+
+        //! Number of characters in the buffer
+        size_t pos ;
+
+        //! Used to format the measures which are not integers
+        ostringstream ss ;
+
+        //! True if the buffers are written by a background thread
+        bool background ;
+
+        //! Maximum number of buffers waiting to be written by the background thread
+        int maxPending ;
+
+        //! Background thread (0 if not started)
+        thread * writerThread ;
+
+        //! Protects the buffers shared with the background thread
+        mutex lock ;
+
+        //! Used to wake up the background thread and the algorithm
+        condition_variable cond ;
+
+        //! Buffers waiting to be written by the background thread
+        deque< vector< char > > pending ;
+
+        //! Buffers written, reused when a buffer is full
+        vector< vector< char > > freeBuffers ;
+
+        //! Number of buffers not yet written (waiting or being written)
+        int nbPending ;
+
+        //! True when the background thread must stop
+        bool stop ;
+
+        //! Open the file (and start the background thread)
+        void open() ;
+
+        //! Open the file at the first write
+        /**
+            \return false if the file cannot be opened (nothing must be written)
+        */
+        bool ready(){ if( ! writefile && ! error ) open() ; return writefile != 0 ; }
+
+        //! Write the buffer in the file (or pass it to the background thread)
+        void flushBuffer() ;
+
+        //! Loop of the background thread: write the buffers passed until stop
+        void writeBuffers() ;
+
+        //! Append a character
+        void append( char c ){ if( pos == bufferSize ) flushBuffer() ; buffer[ pos++ ] = c ; }
+
+        //! Append a string
+        void append( const char * str ) ;
+
+        //! Append an integer
+        void appendInteger( unsigned long long val, bool negative ) ;
+
+        void append( int val ){ appendInteger( val < 0 ? 0ULL - (unsigned long long) val : val, val < 0 ) ; }
+        void append( unsigned int val ){ appendInteger( val, false ) ; }
+        void append( long val ){ appendInteger( val < 0 ? 0ULL - (unsigned long long) val : val, val < 0 ) ; }
+        void append( unsigned long val ){ appendInteger( val, false ) ; }
+        void append( long long val ){ appendInteger( val < 0 ? 0ULL - (unsigned long long) val : val, val < 0 ) ; }
+        void append( unsigned long long val ){ appendInteger( val, false ) ; }
+
+        //! Append an object with its operator <<
+        template< class T >
+        void appendStream( const T & val )
+        {
+            ss.str( "" ) ;
+            ss << val ;
+            append( ss.str().c_str() ) ;
+        }
+
+        //! Append a measure (or an element)
+        template< class T >
+        void append( const T & val ){ appendValue( outputValue( val ) ) ; }
+
+        void appendValue( int val ){ append( val ) ; }
+        void appendValue( long val ){ append( val ) ; }
+        void appendValue( long long val ){ append( val ) ; }
+        void appendValue( unsigned int val ){ append( val ) ; }
+        void appendValue( unsigned long val ){ append( val ) ; }
+        void appendValue( unsigned long long val ){ append( val ) ; }
+
+        template< class T >
+        void appendValue( const T & val ){ appendStream( val ) ; }
+
+        //! Append the elements of a set (each element is followed by a space, as in FimiFile)
+        template< class InputIterator >
+        void appendSet( InputIterator first, InputIterator last )
+        {
+            for( ; first != last ; ++first )
+            {
+                append( *first ) ;
+                append( ' ' ) ;
+            }
+        }
+
+    private:
+
+        //! Copy is not allowed (the background thread references the object)
+        FimiFileBuffered( const FimiFileBuffered & ) ;
+        FimiFileBuffered & operator = ( const FimiFileBuffered & ) ;
+
+    public:
+
+        //! Constructor.
+        /**
+            \param inFileName name of the file
+            \param inBackground true if the buffers are written by a background thread
+            \param inBufferSize size of the buffers (in bytes)
+        */
+        FimiFileBuffered( const char * inFileName, bool inBackground = false, size_t inBufferSize = 1 << 20 )
+        {
+            fileName = inFileName ;
+            writefile = 0 ;
+            error = false ;
+            bufferSize = inBufferSize > 64 ? inBufferSize : 64 ;
+            buffer.resize( bufferSize ) ;
+            pos = 0 ;
+            background = inBackground ;
+            maxPending = 4 ;
+            writerThread = 0 ;
+            nbPending = 0 ;
+            stop = false ;
+        }
+
+        //! Destructor.
+        /**
+           The destructor writes the buffers and closes the file.
+        */
+        virtual ~FimiFileBuffered(){ close() ; }
+
+        //! Write all the data in the file (and wait for the background thread)
+        void flush() ;
+
+        //! Write all the data and close the file
+        void close() ;
+
+        //! Extract all the  data of the container and insert it in a file .
+        /**
+           \param container where the data is read.
+           \return *this.
+        */
+        template< class ContainerBdT >
+        FimiFileBuffered & operator<< ( ContainerBdT & container )
+        {
+            if( ! ready() ) return *this ;
+
+            for( typename ContainerBdT::iterator it = container.begin(); it != container.end();++it )
+            {
+                appendSet( (*it).begin(), (*it).end() ) ;
+                append( it.measure() ) ;
+                append( '\n' ) ;
+            }
+            return *this;
+        }
+
+        FimiFileBuffered & operator<< ( char * str ){ if( ready() ) append( (const char *) str ) ; return *this ; }
+
+        FimiFileBuffered & operator<< ( const char * str ){ if( ready() ) append( str ) ; return *this ; }
+
+        FimiFileBuffered & operator<< ( int i ){ if( ready() ) append( i ) ; return *this ; }
+
+        FimiFileBuffered & operator<< ( vector<SetsType> & v )
+        {
+            if( ! ready() ) return *this ;
+            int size = v.size();
+            for( int i = 0; i < size -1; ++i )
+            {
+                append( v[ i ] ) ;
+                append( ' ' ) ;
+            }
+            if( size ) append( v[ size - 1 ] ) ;
+
+            return *this;
+        }
+
+        //! Insert an itemset in the file.
+        /**
+            This function corresponds to the classic push_back( ) function od STL container.
+            The template parameter represents a container of integers.
+            \param setElement the set of element to insert in the file.
+            \param supp the support of the itemset.
+        */
+        template< class Container, class Val >
+        void push_back(  Container & setElement, Val  supp   )
+        {
+            if( ! ready() ) return ;
+            appendSet( setElement.begin(), setElement.end() ) ;
+            append( supp ) ;
+            append( '\n' ) ;
+        }
+
+        //! Insert an itemset in the file.
+        /**
+            This function corresponds to the classic push_back( ) function od STL container.
+            The template parameter represents a container of integers.
+            \param setElement the set of element to insert in the file.
+        */
+        template< class Container >
+        void push_back(  Container & setElement  )
+        {
+            if( ! ready() ) return ;
+            appendSet( setElement.begin(), setElement.end() ) ;
+            append( '\n' ) ;
+        }
+
+        //! Insert a set of element in the file.
+        /**
+            The template parameter represents the input iterators on the integers to insert in the file.
+            \param first iterator on the first element.
+            \param last iterator on the element after the last.
+            \param supp the support of the itemset.
+        */
+        template< class InputIterator,  class Val>
+        void push_back( InputIterator  first, InputIterator last, Val  supp   )
+        {
+            if( ! ready() ) return ;
+            appendSet( first, last ) ;
+            append( supp ) ;
+            append( '\n' ) ;
+        }
+};
+
+//! Open the file (and start the background thread)
+template< class SetsType >
+void FimiFileBuffered< SetsType >::open()
+{
+    writefile = fopen( fileName, "wb" ) ;
+    if( ! writefile )
+    {
+        cerr<<"cannot open file "<< fileName<<endl;
+        error = true ;
+        return ;
+    }
+
+    buffer.resize( bufferSize ) ;
+    pos = 0 ;
+
+    if( background )
+    {
+        stop = false ;
+        writerThread = new thread( writer( this ) ) ;
+    }
+}
+
+//! Append a string
+template< class SetsType >
+void FimiFileBuffered< SetsType >::append( const char * str )
+{
+    size_t length = strlen( str ) ;
+
+    while( length )
+    {
+        if( pos == bufferSize ) flushBuffer() ;
+
+        size_t n = ( length < bufferSize - pos ) ? length : bufferSize - pos ;
+        memcpy( &buffer[ pos ], str, n ) ;
+        pos += n ;
+        str += n ;
+        length -= n ;
+    }
+}
+
+//! Append an integer
+template< class SetsType >
+void FimiFileBuffered< SetsType >::appendInteger( unsigned long long val, bool negative )
+{
+    char digits[ 24 ] ;
+    int n = 0 ;
+
+    do
+    {
+        digits[ n++ ] = '0' + val % 10 ;
+        val /= 10 ;
+    }
+    while( val ) ;
+
+    if( pos + n + 1 > bufferSize ) flushBuffer() ;
+
+    if( negative ) buffer[ pos++ ] = '-' ;
+    while( n ) buffer[ pos++ ] = digits[ --n ] ;
+}
+
+//! Write the buffer in the file (or pass it to the background thread)
+template< class SetsType >
+void FimiFileBuffered< SetsType >::flushBuffer()
+{
+    if( ! pos ) return ;
+
+    if( ! writerThread )
+    {
+        if( writefile ) fwrite( &buffer[ 0 ], 1, pos, writefile ) ;
+        pos = 0 ;
+        return ;
+    }
+
+    unique_lock< mutex > guard( lock ) ;
+
+    // wait if too many buffers are waiting to be written
+    while( nbPending >= maxPending )
+        cond.wait( guard ) ;
+
+    buffer.resize( pos ) ;
+    pending.push_back( vector< char >() ) ;
+    pending.back().swap( buffer ) ;
+    nbPending++ ;
+
+    // continue in a buffer already written (or a new one)
+    if( freeBuffers.size() )
+    {
+        buffer.swap( freeBuffers.back() ) ;
+        freeBuffers.pop_back() ;
+    }
+    buffer.resize( bufferSize ) ;
+    pos = 0 ;
+
+    cond.notify_all() ;
+}
+
+//! Loop of the background thread: write the buffers passed until stop
+template< class SetsType >
+void FimiFileBuffered< SetsType >::writeBuffers()
+{
+    vector< char > current ;
+    unique_lock< mutex > guard( lock ) ;
+
+    while( true )
+    {
+        while( pending.empty() && ! stop )
+            cond.wait( guard ) ;
+
+        if( pending.empty() ) // stop and all the buffers are written
+            break ;
+
+        current.swap( pending.front() ) ;
+        pending.pop_front() ;
+
+        // the file is written without blocking the algorithm
+        guard.unlock() ;
+        fwrite( &current[ 0 ], 1, current.size(), writefile ) ;
+        guard.lock() ;
+
+        freeBuffers.push_back( vector< char >() ) ;
+        freeBuffers.back().swap( current ) ;
+        nbPending-- ;
+        cond.notify_all() ;
+    }
+}
+
+//! Write all the data in the file (and wait for the background thread)
+template< class SetsType >
+void FimiFileBuffered< SetsType >::flush()
+{
+    if( ! writefile ) return ;
+
+    flushBuffer() ;
+
+    if( writerThread )
+    {
+        unique_lock< mutex > guard( lock ) ;
+        while( nbPending )
+            cond.wait( guard ) ;
+    }
+
+    fflush( writefile ) ;
+}
+
+//! Write all the data and close the file
+template< class SetsType >
+void FimiFileBuffered< SetsType >::close()
+{
+    if( ! writefile ) return ;
+
+    flushBuffer() ;
+
+    if( writerThread )
+    {
+        {
+            lock_guard< mutex > guard( lock ) ;
+            stop = true ;
+        }
+        cond.notify_all() ;
+        writerThread->join() ;
+        delete writerThread ;
+        writerThread = 0 ;
+        freeBuffers.clear() ;
+    }
+
+    fclose( writefile ) ;
+    writefile = 0 ;
+    vector< char >().swap( buffer ) ;
+}
+
+#endif
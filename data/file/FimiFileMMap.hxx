@@ -0,0 +1,222 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FIMIFILEMMAP_HXX
+#define FIMIFILEMMAP_HXX
+
+#include <vector>
+#include <thread>
+#include <iostream>
+
+#include "MappedFile.hxx"
+
+using namespace std;
+
+//! Class used to read a transactionnal db in the FIMI format by mapping the file in memory.
+/**
+    The file is mapped in memory (see MappedFile) and the integers are parsed directly in the mapped memory,
+    without copying the lines in strings.
+
+    The transactions are inserted in the container in the same way than FimiFile and FimiFileC (same operator >>),
+    so that it can be used to construct a BinaryDB.
+    Each line is a transaction, and all the characters which are not digits are separators.
+
+    The file can be parsed by several threads: it is split in parts ending with a new line,
+    each thread parses a part, and the transactions are inserted in the container in the order of the file.
+
+    The template parameter SetsType is the type of items in the transactions (an integer type).
+*/
+template< class SetsType=int >
+class FimiFileMMap
+{
+    protected:
+
+        //! Functor parsing a part of the file in a thread
+        class parsePart
+        {
+                const char * first ;
+                const char * last ;
+                vector< SetsType > * items ;
+                vector< int > * ends ;
+                bool lastPart ;
+
+            public:
+
+                parsePart( const char * infirst, const char * inlast, vector< SetsType > * initems, vector< int > * inends, bool inlastPart )
+                {
+                    first = infirst ; last = inlast ; items = initems ; ends = inends ; lastPart = inlastPart ;
+                }
+
+                void operator()(){ parse( first, last, *items, *ends, lastPart ) ; }
+        };
+
+        //! name of the file to used
+        const char * fileName ;
+
+        //! the file mapped in memory
+        MappedFile file ;
+
+        //! Parse the lines of a part of the file
+        /**
+            \param first first character of the part
+            \param last character after the last character of the part
+            \param items the items of all the lines are inserted at the end of this vector
+            \param ends the position in items of the end of each line is inserted at the end of this vector
+            \param lastPart true if this the last part of the file (the characters after the last new line are a line)
+        */
+        static void parse( const char * first, const char * last, vector< SetsType > & items, vector< int > & ends, bool lastPart ) ;
+
+        //! Insert in a container the lines parsed
+        template< class ContainerDB >
+        static void insert( ContainerDB & container, vector< SetsType > & items, vector< int > & ends ) ;
+
+    public:
+
+        //! Number of threads used to parse the file (1 by default, ie no thread)
+        int nbThreads ;
+
+        //! Constructor.
+        /**
+            \param inFileName name of the file
+            \param inNbThreads number of threads used to parse the file
+        */
+        FimiFileMMap( const char * inFileName, int inNbThreads = 1 ){ fileName = inFileName ; nbThreads = inNbThreads ; }
+
+        //! Destructor.
+        virtual ~FimiFileMMap(){}
+
+        //! Extract all the data of the file and insert it in a container.
+        /**
+           \param container where the data read is inserted (must have a push_back function).
+           \return *this.
+        */
+        template< class ContainerDB >
+        FimiFileMMap & operator>> ( ContainerDB & container ) ;
+};
+
+//! Parse the lines of a part of the file
+template< class SetsType >
+void FimiFileMMap< SetsType >::parse( const char * first, const char * last, vector< SetsType > & items, vector< int > & ends, bool lastPart )
+{
+    const char * p = first ;
+    SetsType item ;
+    char c ;
+
+    while( p < last )
+    {
+        c = *p ;
+
+        if( c >= '0' && c <= '9' ) // read an integer
+        {
+            item = 0 ;
+            do
+            {
+                item = item * 10 + ( c - '0' ) ;
+                ++p ;
+            }
+            while( p < last && ( c = *p ) >= '0' && c <= '9' ) ;
+
+            items.push_back( item ) ;
+        }
+        else
+        {
+            if( c == '\n' ) // end of the line
+                ends.push_back( items.size() ) ;
+            ++p ;
+        }
+    }
+
+    // as in FimiFile, the characters after the last new line of the file are a line (eventually empty)
+    if( lastPart )
+        ends.push_back( items.size() ) ;
+}
+
+//! Insert in a container the lines parsed
+template< class SetsType > template< class ContainerDB >
+void FimiFileMMap< SetsType >::insert( ContainerDB & container, vector< SetsType > & items, vector< int > & ends )
+{
+    vector< SetsType > line ;
+    int begin = 0 ;
+
+    for( unsigned int l = 0 ; l < ends.size() ; l++ )
+    {
+        line.assign( items.begin() + begin, items.begin() + ends[ l ] ) ;
+        container.push_back( line ) ;
+        begin = ends[ l ] ;
+    }
+}
+
+//! Extract all the data of the file and insert it in a container.
+template< class SetsType > template< class ContainerDB >
+FimiFileMMap< SetsType > & FimiFileMMap< SetsType >::operator>> ( ContainerDB & container )
+{
+    if( ! file.open( fileName ) )
+    {
+        cerr<<"cannot open file "<< fileName<<endl;
+        return *this ;
+    }
+
+    const char * data = file.data() ;
+    size_t length = file.size() ;
+
+    // split the file in parts ending with a new line (the last part ends at the end of the file)
+    vector< const char * > limits ;
+    limits.push_back( data ) ;
+    for( int t = 1 ; t < nbThreads ; t++ )
+    {
+        const char * p = data + length / nbThreads * t ;
+        if( p < limits.back() ) p = limits.back() ;
+        while( p < data + length && *p != '\n' ) ++p ;
+        if( p < data + length ) ++p ;
+        if( p > limits.back() && p < data + length ) // no empty part
+            limits.push_back( p ) ;
+    }
+    limits.push_back( data + length ) ;
+
+    int nbParts = limits.size() - 1 ;
+
+    vector< vector< SetsType > > items( nbParts ) ;
+    vector< vector< int > > ends( nbParts ) ;
+
+    if( nbParts == 1 )
+        parse( data, data + length, items[ 0 ], ends[ 0 ], true ) ;
+    else
+    {
+        vector< thread > threads ;
+        for( int t = 0 ; t < nbParts ; t++ )
+            threads.push_back( thread( parsePart( limits[ t ], limits[ t + 1 ], &items[ t ], &ends[ t ], t == nbParts - 1 ) ) ) ;
+        for( int t = 0 ; t < nbParts ; t++ )
+            threads[ t ].join() ;
+    }
+
+    // insert the transactions in the order of the file
+    for( int t = 0 ; t < nbParts ; t++ )
+    {
+        insert( container, items[ t ], ends[ t ] ) ;
+        vector< SetsType >().swap( items[ t ] ) ;
+        vector< int >().swap( ends[ t ] ) ;
+    }
+
+    file.close() ;
+
+    return *this ;
+}
+
+#endif
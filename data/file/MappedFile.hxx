@@ -0,0 +1,144 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef MAPPEDFILE_HXX
+#define MAPPEDFILE_HXX
+
+#include <vector>
+#include <cstdio>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//! Class giving a read only access to the content of a file mapped in memory.
+/**
+    The file is mapped in memory with mmap.
+    If the file cannot be mapped (or on Windows), it is read in a buffer with one fread.
+*/
+class MappedFile
+{
+    protected:
+
+        //! content of the file
+        const char * content ;
+
+        //! size of the file
+        size_t length ;
+
+        //! true if the file is mapped in memory
+        bool mapped ;
+
+        //! used to store the file when it cannot be mapped in memory
+        vector< char > buffer ;
+
+    public:
+
+        //! Constructor.
+        MappedFile(){ content = 0 ; length = 0 ; mapped = false ; }
+
+        //! Destructor.
+        ~MappedFile(){ close() ; }
+
+        //! Map a file in memory (or read it in the buffer)
+        /**
+            \param fileName name of the file
+            \param sequential true if the file is read sequentially (used to advise the system)
+            \return false if the file cannot be read
+        */
+        bool open( const char * fileName, bool sequential = true ) ;
+
+        //! Unmap the file (or delete the buffer)
+        void close() ;
+
+        //! Return the content of the file (0 if the file is empty or not open)
+        const char * data() const { return content ; }
+
+        //! Return the size of the file
+        size_t size() const { return length ; }
+
+    private:
+
+        //! Copy is not allowed (the file would be unmapped twice)
+        MappedFile( const MappedFile & ) ;
+        MappedFile & operator = ( const MappedFile & ) ;
+};
+
+//! Map a file in memory (or read it in the buffer)
+inline bool MappedFile::open( const char * fileName, bool sequential )
+{
+    close() ;
+
+#ifndef _WIN32
+    int fd = ::open( fileName, O_RDONLY ) ;
+    if( fd < 0 ) return false ;
+
+    struct stat st ;
+    if( fstat( fd, &st ) == 0 && st.st_size > 0 )
+    {
+        void * addr = mmap( 0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 ) ;
+        if( addr != MAP_FAILED )
+        {
+            if( sequential )
+                madvise( addr, st.st_size, MADV_SEQUENTIAL ) ;
+            content = (const char *) addr ;
+            length = st.st_size ;
+            mapped = true ;
+        }
+    }
+    ::close( fd ) ;
+    if( mapped ) return true ;
+#endif
+
+    // the file cannot be mapped, it is read in the buffer
+    FILE * file = fopen( fileName, "rb" ) ;
+    if( ! file ) return false ;
+
+    fseek( file, 0, SEEK_END ) ;
+    long size = ftell( file ) ;
+    fseek( file, 0, SEEK_SET ) ;
+
+    buffer.resize( size > 0 ? size : 0 ) ;
+    length = size > 0 ? fread( &buffer[0], 1, size, file ) : 0 ;
+    content = length ? &buffer[0] : 0 ;
+    fclose( file ) ;
+
+    return true ;
+}
+
+//! Unmap the file (or delete the buffer)
+inline void MappedFile::close()
+{
+#ifndef _WIN32
+    if( mapped )
+        munmap( (void *) content, length ) ;
+#endif
+    mapped = false ;
+    content = 0 ;
+    length = 0 ;
+    vector< char >().swap( buffer ) ;
+}
+
+#endif
@@ -29,6 +29,8 @@
 #include "RecodeToInt.hxx"
 #include "Tatree_base.hxx"
 #include "Tatree.hxx"
+#include "VerticalDB.hxx"
+#include "DBCache.hxx"
 
 using namespace std;
 
@@ -36,10 +38,15 @@ using namespace std;
 /*! 
     This class is used to store in memory the transactional database for frequent itemsets mining.
     By default, the transactions are stored in a trie data structure (Tatree).   
+    For dense databases, they can be stored in a vertical data structure (VerticalDB), ie a bitmap per item.
     First, the transactions are stored in a temporary data structure (matrix).
     From this structure, the frequent items are extracted and reordered.
     After this, the transactions are recontructed (without not frequent items and in increasing oreder of support)
     and inserted in the final data structure.
+    
+    This preprocessing can be saved in a cache (DBCache) to be reused by the next runs on the same file.
+    When the cache is loaded, the file is not read: the items and their support are read in the cache,
+    and the transactions are directly inserted recoded in the final data structure.
                 
     The template parameter SetsType is the type of the elements stored in the db.
     The template parameter DataStructDB is a container of sets to store the transactions in memory.   
@@ -54,6 +61,9 @@ class BinaryDB
         
         //! This container store the transactionnal database with ordered transactions of frequent items.
         DataStructDB db;  
+        
+        //! Cache of the preprocessed db (0 if no cache is used)
+        DBCache<SetsType> * cache ;
                
     
     public:
@@ -72,6 +82,7 @@ class BinaryDB
         BinaryDB( InputFormat & format, bool inverbose = false )
         {  
             tmpDB = new vector< vector<SetsType> > ; 
+            cache = 0 ;
             
             clock_t start = clock();
        
@@ -87,6 +98,39 @@ class BinaryDB
       
         }
         
+        //! Constructor using a cache of the preprocessed db.
+        /**
+            If the cache is valid (see DBCache::load()), the file is not read and the db is read in the cache.
+            Else the constructor transfer the data from the input stream to a temporay data structure,
+            and the cache is saved after the preprocessing of the items (see saveCache()).
+            The template parameter is a stream manipulator that input the data from the db.
+            \param format the input stream
+            \param incache the cache (associated to the file of the input stream)
+        */
+        template< class InputFormat >
+        BinaryDB( InputFormat & format, DBCache<SetsType> & incache, bool inverbose = false )
+        {  
+            tmpDB = 0 ; 
+            cache = & incache ;
+            
+            clock_t start = clock();
+       
+            if( ! cache->load() )
+            {
+                tmpDB = new vector< vector<SetsType> > ; 
+                format >> *tmpDB;
+            }
+
+            verbose = inverbose ;
+ 
+            if( verbose )
+            {
+              cout<<( tmpDB ? "reading file [" : "loading cache [" )<<(clock()-start)/CLOCKS_PER_SEC<<"s]"<<endl;
+              cout<<endl;
+            }
+      
+        }
+        
         //! Destructor.
         ~BinaryDB() { if( tmpDB ) delete tmpDB ; } 
         
@@ -135,6 +179,27 @@ class BinaryDB
             
         }         
         
+        //! Return true if the db is read in the cache
+        bool cached() { return cache && cache->loaded() ; }
+        
+        //! Return the cache (0 if no cache is used)
+        DBCache<SetsType> * getCache() { return cache ; }
+        
+        //! Save the transactions in the cache (if a cache is used and not loaded)
+        /**
+            The template parameter ListItemSupp is a container of pairs (item, support).
+            \param listItems all the items of the db with their support, in increasing order of support
+        */
+        template< class ListItemSupp >
+        void saveCache( ListItemSupp & listItems ) 
+        { 
+            if( cache && ! cache->loaded() && tmpDB && ! cache->save( listItems, *tmpDB ) && verbose )
+                cout<<"cannot save the cache"<<endl;
+        }
+        
+        //! Unload the cache (when the transactions have been inserted in the final data structure)
+        void releaseCache() { if( cache ) cache->close() ; }
+        
         //! Set the recode function in the reconstructed data
         void setRecode( RecodeToInt<SetsType> * inrecode ) { db.setRecode(inrecode); }
         
@@ -0,0 +1,281 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef VERTICALDB_HXX
+#define VERTICALDB_HXX
+
+#include <vector>
+#include <iterator>
+
+#include "RecodeToInt.hxx"
+
+using namespace std;
+
+//! Template class representing a vertical database, ie a bitmap of the transactions containing each element.
+/**
+   The bit t of the bitmap of an element is set if the t-th transaction contains this element.
+   The support of a set of elements is the number of bits set in the intersection (and) of the bitmaps of its elements.
+   This data structure is more efficient than a trie (Tatree) for dense databases.
+   It can be used as the DataStructDB parameter of a BinaryDB.
+
+   The template parameter is the type of the element stored.
+*/
+template<class SetsType >
+class VerticalDB
+{
+    public:
+
+        //! Type of the words of the bitmaps
+        typedef unsigned long long Word ;
+
+        //! Type of a bitmap
+        typedef vector< Word > Bitmap ;
+
+        //! Used to have the same syntax tha the STL (iterator on the bitmaps of the elements)
+        typedef typename vector< Bitmap >::iterator iterator;
+
+        //! Number of bits in a word
+        static const int wordSize = 8 * sizeof( Word ) ;
+
+    protected:
+
+        //! Bitmap of each element (wrt the internal id of the elements).
+        vector< Bitmap > bitmaps ;
+
+        //! Functor used to recode and order elements
+        RecodeToInt<SetsType> * recode ;
+
+        //! number of sets stored
+        int nbSets;
+
+        //! Set the bits of the transactions nbSets to nbSets+nb-1 in the bitmap of an element
+        void setBits( int elem, int nb )
+        {
+             if( elem >= (int) bitmaps.size() )
+                 bitmaps.resize( elem + 1 ) ;
+
+             Bitmap & bitmap = bitmaps[ elem ] ;
+             if( (int) bitmap.size() * wordSize < nbSets + nb )
+                 bitmap.resize( ( nbSets + nb + wordSize - 1 ) / wordSize, 0 ) ;
+
+             for( int t = nbSets ; t < nbSets + nb ; t++ )
+                  bitmap[ t / wordSize ] |= ( (Word) 1 ) << ( t % wordSize ) ;
+        }
+
+        //! Insert the sets stored in a trie
+        /**
+            The sets ending in a node are inserted as many times as the measure of the node minus the measures of its child nodes.
+            \param itData iterator on the current node of the trie
+            \param path the elements of the current node
+        */
+        template< class IteratorData >
+        void pushTrie( IteratorData itData, vector<int> & path )
+        {
+            int nbEnd = path.empty() ? 0 : itData.measure() ; // the empty sets do not contain any element
+
+            IteratorData it = itData ;
+            it.beginChildNode() ;
+
+            while( it != IteratorData() )
+            {
+                path.push_back( it.elementId() ) ;
+                nbEnd -= it.measure() ;
+
+                pushTrie( it, path ) ;
+
+                path.pop_back() ;
+                it.nextChild() ;
+            }
+
+            if( nbEnd > 0 )
+                push_back( path.begin(), path.end(), nbEnd ) ;
+        }
+
+    public:
+
+        //! Constructor
+        VerticalDB( ){ nbSets = 0; recode = 0;}
+
+        //! Destructor
+        ~VerticalDB()
+        {
+            if( recode )
+                delete recode;
+        }
+
+        //! Push back a set of element.
+        /**
+            This function corresponds to the classic push_back( ) function od STL container.
+            The template parameter represents a container of element of type SetsType.
+            \param setElement the set of element to insert
+            \param nb the number of times the set is inserted
+        */
+        template< class Container >
+        void push_back(  Container & setElement, int nb = 1 )
+        {
+            if( recode )
+            {
+                vector<int> & recoded = (*recode)( setElement) ;
+                push_back( recoded.begin(), recoded.end(), nb ) ;
+            }
+            else
+                push_back( setElement.begin(), setElement.end(), nb ) ;
+        }
+
+        //! Push back a set of element.
+        /**
+            The template parameter represents the input iterators on the elements (internal ids) to insert.
+            \param first iterator on the first element
+            \param last iterator on the element after the last
+            \param nb the number of times the set is inserted
+        */
+        template< class InputIterator>
+        void push_back( InputIterator first, InputIterator last, int nb = 1  )
+        {
+            for( ; first != last ; ++first )
+                 setBits( *first, nb ) ;
+
+            nbSets = nbSets + nb ;
+        }
+
+        //! Build the vertical db from a db stored in a trie (for example a Tatree), with the same internal ids
+        /**
+            \param data the db
+        */
+        template< class DataStructDB >
+        void build( DataStructDB & data )
+        {
+            vector<int> path ;
+
+            bitmaps.clear() ;
+            nbSets = 0 ;
+            pushTrie( data.beginRoot(), path ) ;
+        }
+
+        //! Build the vertical db from another vertical db (the bitmaps are copied)
+        /**
+            \param data the db
+        */
+        template< class SetsTypeDB >
+        void build( VerticalDB<SetsTypeDB> & data )
+        {
+            bitmaps.resize( data.nbElements() ) ;
+            for( int i = 0 ; i < data.nbElements() ; i++ )
+                 bitmaps[ i ] = data.bitmap( i ) ;
+
+            nbSets = data.size() ;
+        }
+
+        void setRecode( RecodeToInt<SetsType> * inrecode ) { recode =inrecode; }
+
+        //! Function that returns the number of sets stored
+        int size(){ return nbSets; }
+
+        //! Function that returns the number of words of a complete bitmap
+        int nbWords(){ return ( nbSets + wordSize - 1 ) / wordSize ; }
+
+        //! Function that returns the number of elements (the greatest internal id + 1)
+        int nbElements(){ return bitmaps.size() ; }
+
+        //! Return the bitmap of an element (the bitmap can be shorter than nbWords(), the missing words are 0)
+        /**
+            \param elem internal id of the element
+        */
+        Bitmap & bitmap( int elem ){ return bitmaps[ elem ] ; }
+
+        //! Return an iterator on the bitmap of the first element.
+        iterator begin() { return bitmaps.begin();  }
+
+        //! Return an iterator on the bitmap of the first element.
+        iterator beginRoot() { return bitmaps.begin();  }
+
+        //! Return an iterator after the bitmap of the last element.
+        iterator end() { return bitmaps.end() ; }
+
+        //! Return the number of bits set in a word
+        static int popcount( Word w )
+        {
+            #ifdef __GNUC__
+            return __builtin_popcountll( w ) ;
+            #else
+            int nb = 0 ;
+            for( ; w ; nb++ ) w &= w - 1 ;
+            return nb ;
+            #endif
+        }
+
+        //! Intersect two bitmaps and return the number of bits set in the result
+        /**
+            \param b1 first bitmap
+            \param b2 second bitmap
+            \param result bitmap storing the intersection (or 0 if it is not needed)
+            \return the number of transactions in the intersection
+        */
+        static int intersect( const Bitmap & b1, const Bitmap & b2, Bitmap * result = 0 )
+        {
+            int n = b1.size() < b2.size() ? b1.size() : b2.size() ;
+            int nb = 0 ;
+
+            if( result )
+            {
+                result->resize( n ) ;
+                for( int w = 0 ; w < n ; w++ )
+                    nb += popcount( (*result)[ w ] = b1[ w ] & b2[ w ] ) ;
+            }
+            else
+            {
+                for( int w = 0 ; w < n ; w++ )
+                    nb += popcount( b1[ w ] & b2[ w ] ) ;
+            }
+
+            return nb ;
+        }
+
+        //! Unite two bitmaps and return the number of bits set in the result
+        /**
+            \param b1 first bitmap
+            \param b2 second bitmap
+            \param result bitmap storing the union (or 0 if it is not needed)
+            \return the number of transactions in the union
+        */
+        static int unite( const Bitmap & b1, const Bitmap & b2, Bitmap * result = 0 )
+        {
+            const Bitmap & longest = b1.size() < b2.size() ? b2 : b1 ;
+            int n = b1.size() < b2.size() ? b1.size() : b2.size() ;
+            int nb = 0 ;
+
+            if( result )
+                result->resize( longest.size() ) ;
+
+            for( int w = 0 ; w < (int) longest.size() ; w++ )
+            {
+                Word u = w < n ? b1[ w ] | b2[ w ] : longest[ w ] ;
+                nb += popcount( u ) ;
+                if( result )
+                    (*result)[ w ] = u ;
+            }
+
+            return nb ;
+        }
+
+} ;
+
+
+#endif
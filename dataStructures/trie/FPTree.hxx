@@ -0,0 +1,371 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FPTREE_HXX
+#define FPTREE_HXX
+
+#include <vector>
+#include <map>
+#include <algorithm>
+
+#include "TatreeNode.hxx"
+
+using namespace std;
+
+//! Template class representing a FP-tree (a Tatree with header lists and node-links) stored in an array.
+/**
+    A Tatree already stores the transactions with shared prefixes and a number of sets in each node.
+    The FP-tree adds for each item a header list: its support and its first node, the nodes of an item being linked (node-links).
+    So the prefix paths of an item are found without exploring the trie, and the conditional FP-tree of the item
+    is built from these paths (see conditional()).
+
+    The items of the trie are numbered from 0 in increasing order of their element, and the elements of a path are in increasing order,
+    so the ancestors of a node of the item i are nodes of items smaller than i.
+    A node only stores its item, its number of sets, its parent node, its first child node, its next sibling node and the next node of its item.
+    The root node is the first node of the array.
+
+    The template parameter is the type of the element stored in the trie.
+    \see Tatree
+*/
+template<class SetsType >
+class FPTree
+{
+    public:
+
+        //! Node of the trie
+        struct FPNode
+        {
+            //! Item of the node (-1 for the root node)
+            int item ;
+
+            //! Number of sets stored in the node (and its child nodes)
+            int cnt ;
+
+            //! Index of the parent node (-1 for the root node)
+            int parent ;
+
+            //! Index of the first child node (-1 if none)
+            int child ;
+
+            //! Index of the next child node of the parent node (-1 if none)
+            int sibling ;
+
+            //! Index of the next node of the same item (-1 if none)
+            int link ;
+        };
+
+    protected:
+
+        //! Nodes of the trie
+        vector< FPNode > nodes ;
+
+        //! Element of each item (in increasing order)
+        vector< SetsType > items ;
+
+        //! Index of the first node of each item (the header lists)
+        vector< int > heads ;
+
+        //! Support of each item, ie the number of sets of its nodes
+        vector< int > supports ;
+
+        //! Add a node and link it to its parent node and to the nodes of its item
+        /**
+            \param item the item of the node
+            \param cnt the number of sets of the node
+            \param parent index of the parent node
+            \return the index of the node
+        */
+        int addNode( int item, int cnt, int parent )
+        {
+            FPNode node ;
+            node.item = item ;
+            node.cnt = cnt ;
+            node.parent = parent ;
+            node.child = -1 ;
+            node.sibling = nodes[ parent ].child ;
+            node.link = heads[ item ] ;
+
+            int index = nodes.size() ;
+            nodes.push_back( node ) ;
+
+            nodes[ parent ].child = index ;
+            heads[ item ] = index ;
+            supports[ item ] += cnt ;
+
+            return index ;
+        }
+
+        //! Add the root node (the trie is empty)
+        void addRoot( int cnt )
+        {
+            FPNode root ;
+            root.item = -1 ;
+            root.cnt = cnt ;
+            root.parent = -1 ;
+            root.child = -1 ;
+            root.sibling = -1 ;
+            root.link = -1 ;
+            nodes.push_back( root ) ;
+        }
+
+        //! Search the elements of a Tatree
+        /**
+            \param currNode the node of the Tatree
+            \param elements the elements found and their item
+        */
+        void searchItems( TatreeNode<SetsType> * currNode, map< SetsType, int > & elements )
+        {
+            typename map< SetsType, TatreeNode<SetsType> * >::iterator it ;
+
+            for( it = currNode->childs().begin() ; it != currNode->childs().end() ; ++it )
+            {
+                if( it->second )
+                {
+                    elements[ it->first ] = 0 ;
+                    searchItems( it->second, elements ) ;
+                }
+            }
+        }
+
+        //! Copy the child nodes of a node of a Tatree
+        /**
+            \param currNode the node of the Tatree
+            \param index index of the copy of the node
+            \param elements the item of each element
+        */
+        void copy( TatreeNode<SetsType> * currNode, int index, map< SetsType, int > & elements )
+        {
+            typename map< SetsType, TatreeNode<SetsType> * >::iterator it ;
+
+            for( it = currNode->childs().begin() ; it != currNode->childs().end() ; ++it )
+                if( it->second )
+                    copy( it->second, addNode( elements[ it->first ], it->second->number(), index ), elements ) ;
+        }
+
+    public:
+
+        //! Constructor (empty trie)
+        FPTree(){}
+
+        //! Constructor copying a trie
+        /**
+            The template parameter is a trie with a getRoot() method (Tatree or Tatree_base).
+        */
+        template< class Trie >
+        FPTree( Trie & trie ){ build( trie ) ; }
+
+        //! Copy a trie (the precedent content is deleted)
+        /**
+            The template parameter is a trie with a getRoot() method (Tatree or Tatree_base).
+        */
+        template< class Trie >
+        void build( Trie & trie )
+        {
+            clear() ;
+
+            TatreeNode<SetsType> * root = trie.getRoot() ;
+
+            if( root )
+            {
+                map< SetsType, int > elements ;
+                searchItems( root, elements ) ;
+
+                for( typename map< SetsType, int >::iterator it = elements.begin() ; it != elements.end() ; ++it )
+                {
+                    it->second = items.size() ;
+                    items.push_back( it->first ) ;
+                }
+
+                heads.assign( items.size(), -1 ) ;
+                supports.assign( items.size(), 0 ) ;
+
+                addRoot( 0 ) ;
+                copy( root, 0, elements ) ;
+
+                // the number of sets of the root node is the number of sets of the trie
+                for( int n = nodes[ 0 ].child ; n != -1 ; n = nodes[ n ].sibling )
+                     nodes[ 0 ].cnt += nodes[ n ].cnt ;
+            }
+        }
+
+        //! Delete all the nodes and items
+        void clear(){ nodes.clear() ; items.clear() ; heads.clear() ; supports.clear() ; }
+
+        //! Return the number of nodes
+        int size() const { return nodes.size() ; }
+
+        //! Return a node
+        const FPNode & node( int index ) const { return nodes[ index ] ; }
+
+        //! Return the number of items
+        int nbItems() const { return items.size() ; }
+
+        //! Return the element of an item
+        SetsType item( int i ) const { return items[ i ] ; }
+
+        //! Return the support of an item
+        int support( int i ) const { return supports[ i ] ; }
+
+        //! Return the index of the first node of an item
+        int head( int i ) const { return heads[ i ] ; }
+
+        //! Return true if the trie is a single path (each node has at most one child node)
+        bool singlePath() const
+        {
+            for( int n = 0 ; n < nodes.size() ; n++ )
+                 if( nodes[ n ].child != -1 && nodes[ nodes[ n ].child ].sibling != -1 )
+                     return false ;
+
+            return true ;
+        }
+
+        //! Return the number of sets of the trie containing some elements
+        /**
+            The nodes of the last element are found with its node-links, and the other elements are searched in their prefix path
+            (the items of a path decrease from a node to the root node, so the search stops at the first item smaller than the element searched).
+            \param elements the elements (in increasing order)
+        */
+        template< class Container >
+        int count( Container & elements ) const
+        {
+            if( nodes.empty() )
+                return 0 ;
+
+            if( elements.empty() )
+                return nodes[ 0 ].cnt ;
+
+            vector< int > local ; // the items of the elements
+
+            for( typename Container::iterator it = elements.begin() ; it != elements.end() ; ++it )
+            {
+                 typename vector< SetsType >::const_iterator pos = lower_bound( items.begin(), items.end(), *it ) ;
+
+                 if( pos == items.end() || *pos != *it )
+                     return 0 ;
+
+                 local.push_back( pos - items.begin() ) ;
+            }
+
+            int cnt = 0 ;
+
+            for( int n = heads[ local.back() ] ; n != -1 ; n = nodes[ n ].link )
+            {
+                 int m = local.size() - 2 ; // the next element searched
+
+                 for( int p = nodes[ n ].parent ; p > 0 && m >= 0 && nodes[ p ].item >= local[ m ] ; p = nodes[ p ].parent )
+                      if( nodes[ p ].item == local[ m ] )
+                          m-- ;
+
+                 if( m < 0 )
+                     cnt += nodes[ n ].cnt ;
+            }
+
+            return cnt ;
+        }
+
+        //! Insert a path from the root node
+        /**
+            \param path the items of the path (in increasing order)
+            \param cnt the number of sets of the path
+        */
+        void insert( vector< int > & path, int cnt )
+        {
+            int index = 0 ;
+
+            nodes[ 0 ].cnt += cnt ;
+
+            for( int p = 0 ; p < path.size() ; p++ )
+            {
+                 int child = nodes[ index ].child ;
+
+                 while( child != -1 && nodes[ child ].item != path[ p ] )
+                        child = nodes[ child ].sibling ;
+
+                 if( child == -1 )
+                     index = addNode( path[ p ], cnt, index ) ;
+                 else
+                 {
+                     nodes[ child ].cnt += cnt ;
+                     supports[ path[ p ] ] += cnt ;
+                     index = child ;
+                 }
+            }
+        }
+
+        //! Build the conditional FP-tree of an item
+        /**
+            The prefix paths of the item are found with its node-links, and inserted in the conditional FP-tree
+            with the number of sets of the node of the item. Only the items whose support in these paths is at least minsup are kept.
+            \param i the item
+            \param minsup the minimum support of the items of the conditional FP-tree
+            \param cond the conditional FP-tree (the precedent content is deleted)
+            \param counts the support of each item j < i in the prefix paths, ie the number of sets containing i and j
+            \param excludeFull if true, the items in all the prefix paths (their count is the support of i) are not kept
+        */
+        void conditional( int i, int minsup, FPTree & cond, vector< int > & counts, bool excludeFull = false ) const
+        {
+            counts.assign( i, 0 ) ;
+
+            for( int n = heads[ i ] ; n != -1 ; n = nodes[ n ].link )
+                 for( int p = nodes[ n ].parent ; p > 0 ; p = nodes[ p ].parent )
+                      counts[ nodes[ p ].item ] += nodes[ n ].cnt ;
+
+            cond.clear() ;
+
+            // the items of the conditional FP-tree
+            vector< int > local( i, -1 ) ;
+
+            for( int j = 0 ; j < i ; j++ )
+            {
+                 if( counts[ j ] >= minsup && ! ( excludeFull && counts[ j ] == supports[ i ] ) )
+                 {
+                     local[ j ] = cond.items.size() ;
+                     cond.items.push_back( items[ j ] ) ;
+                 }
+            }
+
+            cond.heads.assign( cond.items.size(), -1 ) ;
+            cond.supports.assign( cond.items.size(), 0 ) ;
+            cond.addRoot( 0 ) ;
+
+            if( cond.items.empty() )
+                return ;
+
+            vector< int > path ;
+
+            for( int n = heads[ i ] ; n != -1 ; n = nodes[ n ].link )
+            {
+                 path.resize( 0 ) ;
+
+                 for( int p = nodes[ n ].parent ; p > 0 ; p = nodes[ p ].parent )
+                      if( local[ nodes[ p ].item ] != -1 )
+                          path.push_back( local[ nodes[ p ].item ] ) ;
+
+                 reverse( path.begin(), path.end() ) ;
+                 cond.insert( path, nodes[ n ].cnt ) ;
+            }
+        }
+
+        //! Return the number of bytes used by the trie
+        long memory() const { return nodes.size() * sizeof( FPNode ) + items.size() * ( sizeof( SetsType ) + 2 * sizeof( int ) ) ; }
+} ;
+
+
+#endif
@@ -0,0 +1,297 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FLATPTREE_HXX
+#define FLATPTREE_HXX
+
+#include <vector>
+
+#include "Node.hxx"
+#include "PTree.hxx"
+#include "ItFlatPTree.hxx"
+#include "RecodeToInt.hxx"
+#include "Boolean.hpp"
+
+using namespace std;
+
+//! Template class representing a PTree with a flat layout (read only copy of a PTree).
+/**
+    The nodes of a PTree are copied in three arrays, in the depth first order:
+    the headers of the nodes, the presence bitmaps of their elements, and their slots (measure and index of the child node).
+    So the slots of a node are contiguous, and a subtrie is stored in a contiguous part of the arrays.
+    Moving from a node to a child node or to the next element does not follow pointers
+    and the presence of an element is tested with a bit (and not by comparing a Measure with Measure()).
+
+    The structure of the trie can not be modified, only the measures can be modified.
+    They can be copied back in the PTree with storeMeasures().
+    The PTree must not be modified while the FlatPTree is used (the nodes of the PTree are referenced).
+
+    The template parameter SetsType is the type of the elements stored in the trie.
+    The template parameter Measure is the type of the measure associated to the sets.
+    \see PTree, ItFlatPTree
+*/
+template< class SetsType, class Measure=Boolean >
+class FlatPTree
+{
+    public:
+
+        //! Type of the words of the presence bitmaps
+        typedef unsigned long long Word ;
+
+        //! Number of bits in a word
+        static const int wordSize = 8 * sizeof( Word ) ;
+
+        //! Header of a node
+        struct FlatNode
+        {
+            //! Index of the parent node (-1 for the root)
+            int parent ;
+
+            //! Item (internal id) in the parent node
+            int id ;
+
+            //! Internal id of the first element of the node
+            int offset ;
+
+            //! Number of elements of the node (present or not)
+            int size ;
+
+            //! Index of the first slot of the node
+            int first ;
+
+            //! Index of the first word of the presence bitmap of the node
+            int firstWord ;
+
+            //! Node of the PTree copied
+            Node<SetsType,Measure> * source ;
+        };
+
+        //! Measure and child node of an element
+        struct Slot
+        {
+            Measure measure ;
+
+            //! Index of the child node (0 if there is no child node, the root is never a child)
+            int child ;
+        };
+
+        //! Used to have the same syntax tha the STL
+        typedef ItFlatPTree<SetsType,Measure> iterator ;
+
+    protected:
+
+        //! Headers of the nodes (the root is the first)
+        vector< FlatNode > nodes ;
+
+        //! Slots of the nodes
+        vector< Slot > slots ;
+
+        //! Presence bitmaps of the nodes
+        vector< Word > presence ;
+
+        //! Length of the longest branch of the trie
+        int height ;
+
+        //! Copy a node and its child nodes
+        /**
+            \param currNode the node to copy
+            \param parent index of the parent node
+            \param depth depth of the node
+            \return the index of the node
+        */
+        int copy( Node<SetsType,Measure> * currNode, int parent, int depth ) ;
+
+    public:
+
+        //! recode functor used to remap the internal ids (shared with the PTree copied)
+        RecodeToInt<SetsType> * recode ;
+
+        //! Constructor.
+        /**
+            \param head root node of the trie to copy (0 for an empty trie)
+            \param inRecode recode functor of the trie
+        */
+        FlatPTree( Node<SetsType,Measure> * head = 0, RecodeToInt<SetsType> * inRecode = 0 ){ build( head, inRecode ) ; }
+
+        //! Constructor copying a PTree.
+        FlatPTree( PTree<SetsType,Measure> & t ){ build( t.getHead(), t.recode ) ; }
+
+        //! Copy a trie (the precedent content is deleted)
+        /**
+            \param head root node of the trie to copy (0 for an empty trie)
+            \param inRecode recode functor of the trie
+        */
+        void build( Node<SetsType,Measure> * head, RecodeToInt<SetsType> * inRecode = 0 )
+        {
+            nodes.resize( 0 ) ;
+            slots.resize( 0 ) ;
+            presence.resize( 0 ) ;
+            height = 0 ;
+            recode = inRecode ;
+
+            if( head )
+                copy( head, -1, 0 ) ;
+        }
+
+        //! Copy the measures in the nodes of the PTree copied
+        void storeMeasures()
+        {
+            for( int n = 0 ; n < nodes.size() ; n++ )
+                for( int i = 0 ; i < nodes[ n ].size ; i++ )
+                     nodes[ n ].source->getMeasure( i ) = slots[ nodes[ n ].first + i ].measure ;
+        }
+
+        //! Return the header of a node
+        const FlatNode & node( int n ) const { return nodes[ n ] ; }
+
+        //! Test if the i-th element of a node is present
+        bool exist( int n, int i ) const { return ( presence[ nodes[ n ].firstWord + i / wordSize ] >> ( i % wordSize ) ) & 1 ; }
+
+        //! Return the index of the lowest bit set in a word (not 0)
+        static int lowestBit( Word w )
+        {
+            #ifdef __GNUC__
+            return __builtin_ctzll( w ) ;
+            #else
+            int i = 0 ;
+            for( ; ! ( w & 1 ) ; i++ ) w >>= 1 ;
+            return i ;
+            #endif
+        }
+
+        //! Return the index of the first element present of a node from the i-th element (the size of the node if there is no such element)
+        int next( int n, int i ) const
+        {
+            const FlatNode & currNode = nodes[ n ] ;
+
+            if( i >= currNode.size ) return currNode.size ;
+
+            int w = i / wordSize ;
+            Word bits = presence[ currNode.firstWord + w ] & ( ~( (Word) 0 ) << ( i % wordSize ) ) ;
+            int nbWords = ( currNode.size + wordSize - 1 ) / wordSize ;
+
+            while( ! bits )
+            {
+                if( ++w == nbWords ) return currNode.size ;
+                bits = presence[ currNode.firstWord + w ] ;
+            }
+
+            i = w * wordSize + lowestBit( bits ) ;
+            return i < currNode.size ? i : currNode.size ;
+        }
+
+        //! Return the index of the child node of the i-th element of a node (0 if there is no child node)
+        int child( int n, int i ) const { return slots[ nodes[ n ].first + i ].child ; }
+
+        //! Return the measure of the i-th element of a node
+        Measure & measure( int n, int i ) { return slots[ nodes[ n ].first + i ].measure ; }
+
+        //! Return an iterator on the first leaf of the trie (exploring the trie from the left to the right).
+        iterator beginLeaf() ;
+
+        //! Return an iterator on the root node of the trie.
+        iterator beginRoot() { return nodes.size() ? iterator( this, 0, -1, 0 ) : iterator() ; }
+
+        //! Return an iterator on the element after the last element stored.
+        iterator end() { return iterator() ; }
+
+        //! Return the length of the longest branch of the trie
+        int length() const { return height ; }
+
+        //! Return the number of nodes
+        int nbNodes() const { return nodes.size() ; }
+
+        //! Return the number of bytes used by the trie
+        long memory() const { return nodes.size() * sizeof( FlatNode ) + slots.size() * sizeof( Slot ) + presence.size() * sizeof( Word ) ; }
+
+        friend class ItFlatPTree<SetsType,Measure> ;
+};
+
+//! Copy a node and its child nodes
+template< class SetsType, class Measure >
+int FlatPTree< SetsType, Measure >::copy( Node<SetsType,Measure> * currNode, int parent, int depth )
+{
+    int n = nodes.size() ;
+    int size = currNode->getCnts() ? currNode->getCnts()->size() : 0 ;
+    typename Node<SetsType,Measure>::vectN * childs = currNode->getChilds() ;
+
+    FlatNode header ;
+    header.parent = parent ;
+    header.id = currNode->getId() ;
+    header.offset = currNode->getOffset() ;
+    header.size = size ;
+    header.first = slots.size() ;
+    header.firstWord = presence.size() ;
+    header.source = currNode ;
+    nodes.push_back( header ) ;
+
+    slots.resize( header.first + size ) ;
+    presence.resize( header.firstWord + ( size + wordSize - 1 ) / wordSize, 0 ) ;
+
+    if( size && height < depth + 1 ) height = depth + 1 ;
+
+    for( int i = 0 ; i < size ; i++ )
+    {
+        slots[ header.first + i ].measure = currNode->getMeasure( i ) ;
+        slots[ header.first + i ].child = 0 ;
+        if( currNode->existVal( i ) )
+            presence[ header.firstWord + i / wordSize ] |= ( (Word) 1 ) << ( i % wordSize ) ;
+    }
+
+    // the child nodes are copied after the node (depth first order)
+    for( int i = 0 ; childs && i < size && i < childs->size() ; i++ )
+    {
+        if( (*childs)[ i ] )
+        {
+            int c = copy( (*childs)[ i ], n, depth + 1 ) ;
+            slots[ header.first + i ].child = c ;
+        }
+    }
+
+    return n ;
+}
+
+//! Return an iterator on the first leaf of the trie (same leaf than PTree::beginLeaf())
+template< class SetsType, class Measure >
+ItFlatPTree< SetsType, Measure > FlatPTree< SetsType, Measure >::beginLeaf()
+{
+    if( nodes.empty() ) return iterator() ;
+
+    iterator it( this, 0, 0, 0 ) ;
+
+    if( nodes[ 0 ].size )
+    {
+        int current = 0 ;
+
+        // we search the first itemset in the trie
+        while( current != -1 && nodes[ current ].size && exist( current, 0 ) )
+        {
+            it.node = current ;
+            ++(it.height) ;
+
+            current = child( current, 0 ) ? child( current, 0 ) : -1 ;
+        }
+        it.internalId = nodes[ it.node ].offset ;
+    }
+
+    return it ;
+}
+
+#endif
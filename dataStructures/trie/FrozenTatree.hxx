@@ -0,0 +1,160 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef FROZENTATREE_HXX
+#define FROZENTATREE_HXX
+
+#include <vector>
+
+#include "TatreeNode.hxx"
+
+using namespace std;
+
+//! Template class representing a read only copy of a Tatree stored in an array (CSR form).
+/**
+    Once the database is built, the Tatree is only read to count the supports.
+    The nodes are copied in one array: the child nodes of a node are contiguous and sorted wrt their element,
+    and the nodes are placed in the depth first order (the child nodes of a node are placed before the nodes of the next subtrie).
+    A node only stores its element, its number of sets and the position of its child nodes,
+    so the child nodes are explored with an index and without following pointers.
+
+    The root node is the first node of the array.
+    The template parameter is the type of the element stored in the trie.
+    \see Tatree
+*/
+template<class SetsType >
+class FrozenTatree
+{
+    public:
+
+        //! Node of the trie
+        struct FrozenNode
+        {
+            //! Element of the node
+            SetsType item ;
+
+            //! Number of sets stored in the node (and its child nodes)
+            int cnt ;
+
+            //! Index of the first child node
+            int first ;
+
+            //! Number of child nodes
+            int nb ;
+        };
+
+    protected:
+
+        //! Nodes of the trie
+        vector< FrozenNode > nodes ;
+
+        //! Copy the child nodes of a node
+        /**
+            \param currNode the node of the Tatree
+            \param index index of the copy of the node
+        */
+        void copy( TatreeNode<SetsType> * currNode, int index )
+        {
+            typename map< SetsType, TatreeNode<SetsType> * >::iterator it ;
+            int first = nodes.size() ;
+            int nb = 0 ;
+
+            // the child nodes are placed together
+            for( it = currNode->childs().begin() ; it != currNode->childs().end() ; ++it )
+            {
+                if( it->second )
+                {
+                    FrozenNode child ;
+                    child.item = it->first ;
+                    child.cnt = it->second->number() ;
+                    child.first = 0 ;
+                    child.nb = 0 ;
+                    nodes.push_back( child ) ;
+                    nb++ ;
+                }
+            }
+
+            nodes[ index ].first = first ;
+            nodes[ index ].nb = nb ;
+
+            // and then their subtries
+            for( it = currNode->childs().begin() ; it != currNode->childs().end() ; ++it )
+            {
+                if( it->second )
+                {
+                    copy( it->second, first ) ;
+                    first++ ;
+                }
+            }
+        }
+
+    public:
+
+        //! Constructor (empty trie)
+        FrozenTatree(){}
+
+        //! Constructor copying a trie
+        /**
+            The template parameter is a trie with a getRoot() method (Tatree or Tatree_base).
+        */
+        template< class Trie >
+        FrozenTatree( Trie & trie ){ build( trie ) ; }
+
+        //! Copy a trie (the precedent content is deleted)
+        /**
+            The template parameter is a trie with a getRoot() method (Tatree or Tatree_base).
+        */
+        template< class Trie >
+        void build( Trie & trie )
+        {
+            nodes.resize( 0 ) ;
+
+            TatreeNode<SetsType> * root = trie.getRoot() ;
+
+            if( root )
+            {
+                FrozenNode head ;
+                head.item = SetsType() ;
+                head.cnt = root->number() ;
+                head.first = 0 ;
+                head.nb = 0 ;
+                nodes.push_back( head ) ;
+                copy( root, 0 ) ;
+            }
+        }
+
+        //! Delete all the nodes
+        void clear(){ nodes.clear() ; }
+
+        //! Return true if the trie has no node
+        bool empty() const { return nodes.empty() ; }
+
+        //! Return the number of nodes
+        int size() const { return nodes.size() ; }
+
+        //! Return a node
+        const FrozenNode & node( int index ) const { return nodes[ index ] ; }
+
+        //! Return the number of bytes used by the trie
+        long memory() const { return nodes.size() * sizeof( FrozenNode ) ; }
+} ;
+
+
+#endif
@@ -0,0 +1,263 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef ITFLATPTREE_HXX
+#define ITFLATPTREE_HXX
+
+#include <vector>
+
+#include "Boolean.hpp"
+#include "RecodeToInt.hxx"
+
+using namespace std;
+
+template<class SetsType, class Measure> class  FlatPTree;
+template<class SetsType, class Measure> class  Node;
+
+//! Iterator on a FlatPTree.
+/**
+    It has the same behavior than ItPTree (the same nodes are visited in the same order),
+    so that the algorithms written for ItPTree (such as Apriori::testSubset) can run on a FlatPTree.
+    The template parameter SetsType is the type of the elements stored in the trie.
+    The template parameter Measure is the type of the measure associated to the sets.
+    \see FlatPTree, ItPTree
+*/
+template<class SetsType, class Measure=Boolean>
+class ItFlatPTree
+{
+    protected:
+
+        //! Current trie
+        FlatPTree<SetsType,Measure> * tree ;
+
+        //! Index of the current node (-1 for the end iterator)
+        int node ;
+
+        //! Internal id of the current element (-1 for the root)
+        int internalId ;
+
+        //! Number of nodes from the root node
+        int height ;
+
+        //! used for sets extraction by * and getInternalset()
+        vector<int> internalset ;
+        vector<SetsType> set ;
+
+    public:
+
+        //! Default constructor (end iterator).
+        ItFlatPTree( FlatPTree<SetsType,Measure> * intree = 0, int innode = -1, int ininternalId = 0, int inheight = 0 )
+        { tree = intree ; node = innode ; internalId = ininternalId ; height = inheight ; }
+
+        //! Copy constructor (the buffers used to extract the sets are not copied)
+        ItFlatPTree( const ItFlatPTree & it ){ tree = it.tree ; node = it.node ; internalId = it.internalId ; height = it.height ; }
+
+        //! Affectation operator
+        ItFlatPTree & operator = ( const ItFlatPTree & it ){ tree = it.tree ; node = it.node ; internalId = it.internalId ; height = it.height ; return (*this) ; }
+
+        //! Equality operator.
+        bool operator == ( const ItFlatPTree & it ) const { return ( node == it.node && internalId == it.internalId ) ; }
+
+        //! Difference operator.
+        bool operator != ( const ItFlatPTree & it ) const { return ( node != it.node || internalId != it.internalId ) ; }
+
+        //! Operator returning the current set.
+        vector<SetsType> & operator * ()
+        {
+            getInternalset() ;
+            set.resize( 0 ) ;
+            for( int i = 0 ; i < internalset.size() ; i++ )
+                 set.push_back( tree->recode->remap( internalset[ i ] ) ) ;
+            return set ;
+        }
+
+        //! Return the current set (with internal ids)
+        vector<int> * getInternalset()
+        {
+            internalset.resize( height ) ;
+            if( node != -1 && height )
+            {
+                int n = node ;
+                internalset[ height - 1 ] = internalId ;
+                for( int i = height - 2 ; i >= 0 ; i-- )
+                {
+                     internalset[ i ] = tree->nodes[ n ].id ;
+                     n = tree->nodes[ n ].parent ;
+                }
+            }
+            return & internalset ;
+        }
+
+        //! Function returning if the iterrator is on a leaf node
+        bool isaLeaf()
+        {
+            int i = internalId - tree->nodes[ node ].offset ;
+            return !( i >= 0 && i < tree->nodes[ node ].size && tree->child( node, i ) ) ;
+        }
+
+        //! Return an iterator on the parent node
+        /**
+           \return an iterator on the parent node if exists, else return default iterator.
+        */
+        ItFlatPTree parentNode()
+        {
+            ItFlatPTree parent ;
+
+            if( node != -1 && internalId != -1 )
+            {
+                if( tree->nodes[ node ].parent == -1 ) // root node
+                {
+                    parent.internalId = -1 ;
+                    parent.node = node ;
+                    parent.height = 0 ;
+                }
+                else
+                {
+                    parent.internalId = tree->nodes[ node ].id ;
+                    parent.node = tree->nodes[ node ].parent ;
+                    parent.height = height - 1 ;
+                }
+                parent.tree = tree ;
+            }
+
+            return parent ;
+        }
+
+        //! Return an iterator on a child node (of the current node) containing the element elem.
+        /**
+            return the default iterator if there is no child node with the element.
+        */
+        ItFlatPTree childNode( SetsType elem ){ return childNodeId( (*tree->recode)( elem ) ) ; }
+
+        //! Return an iterator on a child node (of the current node) containing the element of internal id intid.
+        /**
+            return the default iterator if there is no child node with the element.
+        */
+        ItFlatPTree childNodeId( int intid )
+        {
+            ItFlatPTree result ;
+            int n = node ;
+
+            if( internalId != -1 ) // the elements are in the child node
+            {
+                int index = internalId - tree->nodes[ node ].offset ;
+                if( index < 0 || index >= tree->nodes[ node ].size || ! ( n = tree->child( node, index ) ) )
+                    return result ;
+            }
+
+            int childindex = intid - tree->nodes[ n ].offset ;
+
+            if( childindex >= 0 && childindex < tree->nodes[ n ].size && tree->exist( n, childindex ) )
+            {
+                result.tree = tree ;
+                result.node = n ;
+                result.internalId = intid ;
+                result.height = ( internalId == -1 ) ? 1 : height + 1 ;
+            }
+
+            return result ;
+        }
+
+        //! Return an iterator on the next (wrt order of elements) child node of the current parent node
+        /**
+           \return an iterator on the next (wrt order of elements) child node if exists, else return default iterator.
+        */
+        ItFlatPTree nextChildNode()
+        {
+            int i = tree->next( node, internalId - tree->nodes[ node ].offset + 1 ) ;
+
+            if( i == tree->nodes[ node ].size ) // no other child node
+                return ItFlatPTree() ;
+
+            return ItFlatPTree( tree, node, i + tree->nodes[ node ].offset, height ) ;
+        }
+
+        //! Return an iterator on the next leaf (exploring the tree from the left to the right)
+        ItFlatPTree nextLeaf() ;
+
+        //! Return the depth from the root node.
+        int length() { return height ; }
+
+        //! return the measure associated to the set
+        Measure & measure() { return tree->measure( node, internalId - tree->nodes[ node ].offset ) ; }
+
+        //! Function returning the element in the current node
+        SetsType element() { if( internalId != -1 ) return tree->recode->remap( internalId ) ; else return SetsType() ; }
+
+        //! Function returning the internal id of the element in the current node
+        int elementId() { return internalId ; }
+
+        //! Return the index of the current node in the trie
+        int nodeIndex() { return node ; }
+
+        //! Return the node of the PTree from which the current node has been copied
+        Node<SetsType,Measure> * source() { return tree->nodes[ node ].source ; }
+
+        friend class FlatPTree<SetsType,Measure> ;
+};
+
+//! Return an iterator on the next leaf (exploring the tree from the left to the right)
+template<class SetsType,class Measure>
+ItFlatPTree< SetsType, Measure > ItFlatPTree< SetsType, Measure >::nextLeaf()
+{
+    ItFlatPTree it = *this ;
+
+    int current = it.node ;
+
+    if( current != -1 )
+    {
+        // search the next itemset coded in the current node
+        int i = tree->next( current, it.internalId - tree->nodes[ current ].offset + 1 ) ;
+
+        // no other itemsets from the same node, go to the parent node and search itemset
+        while( current != -1 && i >= tree->nodes[ current ].size )
+        {
+             int parent = tree->nodes[ current ].parent ;
+
+             if( parent != -1 )
+             {
+                  i = tree->nodes[ current ].id + 1 - tree->nodes[ parent ].offset ;
+                  --(it.height) ;
+                  i = tree->next( parent, i ) ;
+             }
+
+             current = parent ;
+        }
+
+        // the next itemset have item in the chid nodes
+        while( current != -1 && i < tree->nodes[ current ].size && tree->child( current, i ) )
+        {
+            ++(it.height) ;
+            current = tree->child( current, i ) ;
+            i = 0 ;
+        }
+
+        if( current != -1 )
+            it.internalId = i + tree->nodes[ current ].offset ;
+        else
+            it.internalId = 0 ;
+
+        it.node = current ;
+    }
+
+    return it ;
+}
+
+#endif
@@ -179,10 +179,15 @@ public:
         /**
             return the default iterator if there is no child node with the element.    
         */
-        ItPTree childNode( SetsType elem )
+        ItPTree childNode( SetsType elem ){ return childNodeId( (*recode)( elem ) ) ; }
+
+        //! Return an iterator on a child node (of the current node) containing the element of internal id intid.
+        /**
+            return the default iterator if there is no child node with the element.    
+        */
+        ItPTree childNodeId( int intid )
         {
              
-            int intid = (*recode)( elem );    
             ItPTree result ;
             int childindex;
             int index = internalId - ptr->offset;
@@ -431,7 +436,7 @@ ItPTree< SetsType, Measure >::ItPTree(PTree< SetsType, Measure > * t )
                                                                   
     if( currNode && currNode->cnts  )
     {
-        recode = &t->recode ;
+        recode = t->recode ;
         
         internalset=0;
         set=0; 
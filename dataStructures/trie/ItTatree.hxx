@@ -66,8 +66,8 @@ class ItTatree
         ItTatree( const ItTatree & it ){ trie = it.trie; prevNode = it.prevNode; } 
         
         //! Affectation operator.
-        ItTatree & operator = ( const ItTatree & it ){ trie = it.trie; prevNode = it.prevNode; } 
-        
+        ItTatree & operator = ( const ItTatree & it ){ trie = it.trie; prevNode = it.prevNode; return (*this) ;}
+
         //! Destructor.
         ~ItTatree(){};
         
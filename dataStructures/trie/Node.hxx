@@ -32,6 +32,7 @@
 #include "ItPTree.hxx"
 #include "RecodeToInt.hxx"
 #include "Boolean.hpp"
+#include "NodeArena.hxx"
 
 using namespace std;
 
@@ -59,12 +60,16 @@ static int globalOffset = 0 ;
 template <class SetsType, class Measure=Boolean>
 class Node
 { 
+  public:
 
-    typedef vector<Measure> vectT;  
-    typedef typename vector<Measure>::iterator vectTit;     
+    //! Vectors of the measures and of the child nodes (allocated in the current arena of the thread)
+    typedef ArenaVector<Measure> vectT;  
+    typedef typename vectT::iterator vectTit;     
     
-    typedef vector<Node *> vectN ;        
-    typedef typename vector<Node *>::iterator vectNit ;      
+    typedef ArenaVector<Node *> vectN ;        
+    typedef typename vectN::iterator vectNit ;      
+
+  private:
     
     //! Functor used to insert an element to the current node
     class insertNode
@@ -353,6 +358,14 @@ public :
 
 	~Node(){ if( cnts ) delete cnts; if( childs ) delete childs; }
 
+	// ------------------------------------------------------
+	// the nodes are allocated in the current arena of the thread
+	// ------------------------------------------------------
+
+	static void * operator new( size_t size ){ return NodeArena::allocateCurrent( size ) ; }
+
+	static void operator delete( void * ptr, size_t size ){ NodeArena::deallocate( ptr, size ) ; }
+
 	// ---------------------
 	// recopy constructor
 	// ---------------------
@@ -0,0 +1,345 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef NODEARENA_HXX
+#define NODEARENA_HXX
+
+#include <vector>
+#include <iostream>
+#include <new>
+#include <cstddef>
+
+using namespace std;
+
+//! Slab allocator used to allocate the nodes of the tries and their vectors.
+/**
+    The memory is reserved by big blocks (slabs) and shared in small blocks.
+    The small blocks released are kept in a list for each size and reused.
+    All the memory of an arena can be released at once (without deleting the nodes one by one).
+
+    Each block begins with a pointer on its arena, so that a block is always released in its arena.
+    The blocks too big for the slabs are allocated with the operator new, and linked in a list of the arena (before their header)
+    so that they are counted in the memory used and released with the arena.
+    The blocks allocated when there is no current arena are allocated with the operator new.
+
+    An arena is not thread safe: it must be used by only one thread at a time.
+*/
+class NodeArena
+{
+        //! Size of the header of the blocks
+        static const size_t headerSize = sizeof( NodeArena * ) ;
+
+        //! Granularity of the sizes of the blocks
+        static const size_t granularity = 8 ;
+
+        //! Maximal size of a block allocated in the slabs
+        static const size_t maxSize = 512 ;
+
+        //! Size of a slab
+        static const size_t slabSize = 64 * 1024 ;
+
+        //! Links of a block too big for the slabs (stored before the header of the block)
+        struct BigBlock
+        {
+            BigBlock * prev ;
+            BigBlock * next ;
+        };
+
+        //! Size of the links of the big blocks
+        static const size_t linkSize = sizeof( BigBlock ) ;
+
+        //! Slabs reserved
+        vector< char * > slabs ;
+
+        //! First free byte of the last slab
+        char * top ;
+
+        //! End of the last slab
+        char * limit ;
+
+        //! List of the free blocks for each size
+        vector< void * > freeBlocks ;
+
+        //! List of the blocks too big for the slabs
+        BigBlock * bigBlocks ;
+
+        //! Number of blocks too big for the slabs not released
+        long nbBigBlocks ;
+
+        //! Index of the list of free blocks of a given size
+        static size_t sizeClass( size_t size ){ return ( size + headerSize + granularity - 1 ) / granularity ; }
+
+    public:
+
+        //! Number of blocks allocated
+        long nbAllocations ;
+
+        //! Number of blocks released
+        long nbDeallocations ;
+
+        //! Number of blocks reused from the lists of free blocks
+        long nbReused ;
+
+        //! Number of bytes used by the blocks not released
+        long bytesUsed ;
+
+        //! Maximal number of bytes used
+        long maxBytesUsed ;
+
+        //! Constructor
+        NodeArena()
+        {
+            top = limit = 0 ;
+            freeBlocks.resize( sizeClass( maxSize ) + 1, (void*) 0 ) ;
+            bigBlocks = 0 ;
+            nbBigBlocks = 0 ;
+            nbAllocations = nbDeallocations = nbReused = bytesUsed = maxBytesUsed = 0 ;
+        }
+
+        //! Destructor (release all the memory)
+        ~NodeArena(){ release() ; }
+
+        //! Allocate a block
+        /**
+            \param size the size of the block
+            \return a pointer on the block
+        */
+        void * allocate( size_t size )
+        {
+            size_t c = sizeClass( size ) ;
+            size_t bytes = c * granularity ;
+            char * block ;
+
+            if( size > maxSize ) // linked in the list of the big blocks
+            {
+                 BigBlock * big = (BigBlock*) ::operator new( size + headerSize + linkSize ) ;
+                 big->prev = 0 ;
+                 big->next = bigBlocks ;
+                 if( bigBlocks ) bigBlocks->prev = big ;
+                 bigBlocks = big ;
+                 nbBigBlocks++ ;
+
+                 block = (char*) big + linkSize ;
+                 bytes = blockBytes( size ) ;
+            }
+            else if( freeBlocks[ c ] )
+            {
+                 block = (char*) freeBlocks[ c ] ;
+                 freeBlocks[ c ] = *(void**) ( block + headerSize ) ;
+                 nbReused++ ;
+            }
+            else
+            {
+                 if( top + bytes > limit ) // reserve a new slab
+                 {
+                     top = new char[ slabSize ] ;
+                     limit = top + slabSize ;
+                     slabs.push_back( top ) ;
+                 }
+                 block = top ;
+                 top += bytes ;
+            }
+
+            *(NodeArena**) block = this ;
+
+            nbAllocations++ ;
+            bytesUsed += bytes ;
+            if( bytesUsed > maxBytesUsed ) maxBytesUsed = bytesUsed ;
+
+            return block + headerSize ;
+        }
+
+        //! Release a block in its arena
+        /**
+            \param ptr pointer on the block
+            \param size the size of the block
+        */
+        static void deallocate( void * ptr, size_t size )
+        {
+            if( ! ptr ) return ;
+
+            char * block = (char*) ptr - headerSize ;
+            NodeArena * arena = *(NodeArena**) block ;
+
+            if( arena && size > maxSize )
+            {
+                 BigBlock * big = (BigBlock*) ( block - linkSize ) ;
+                 if( big->prev ) big->prev->next = big->next ;
+                 else arena->bigBlocks = big->next ;
+                 if( big->next ) big->next->prev = big->prev ;
+
+                 arena->nbBigBlocks-- ;
+                 arena->nbDeallocations++ ;
+                 arena->bytesUsed -= blockBytes( size ) ;
+                 ::operator delete( big ) ;
+            }
+            else if( arena )
+            {
+                 size_t c = sizeClass( size ) ;
+                 *(void**) ptr = arena->freeBlocks[ c ] ;
+                 arena->freeBlocks[ c ] = block ;
+                 arena->nbDeallocations++ ;
+                 arena->bytesUsed -= c * granularity ;
+            }
+            else
+                 ::operator delete( block ) ;
+        }
+
+        //! Allocate a block in the current arena of the thread (or with the operator new if there is no current arena)
+        static void * allocateCurrent( size_t size )
+        {
+            if( current() )
+                return current()->allocate( size ) ;
+
+            char * block = (char*) ::operator new( size + headerSize ) ;
+            *(NodeArena**) block = 0 ;
+            return block + headerSize ;
+        }
+
+        //! Release all the memory of the arena
+        /**
+            The destructors of the objects stored are not called.
+            The time complexity depends only on the number of slabs.
+        */
+        void release()
+        {
+            for( size_t i = 0 ; i < slabs.size() ; i++ )
+                 delete [] slabs[ i ] ;
+            slabs.clear() ;
+
+            while( bigBlocks )
+            {
+                 BigBlock * next = bigBlocks->next ;
+                 ::operator delete( bigBlocks ) ;
+                 bigBlocks = next ;
+            }
+            nbBigBlocks = 0 ;
+
+            top = limit = 0 ;
+            for( size_t c = 0 ; c < freeBlocks.size() ; c++ )
+                 freeBlocks[ c ] = 0 ;
+
+            nbDeallocations = nbAllocations ;
+            bytesUsed = 0 ;
+        }
+
+        //! Return the number of bytes used by a block of a given size (with its header, and its links if it is too big for the slabs)
+        /**
+            \param size the size of the block
+        */
+        static long blockBytes( size_t size ){ return size > maxSize ? size + headerSize + linkSize : sizeClass( size ) * granularity ; }
+
+        //! Return the number of bytes reserved by the arena
+        long bytesReserved(){ return slabs.size() * slabSize ; }
+
+        //! Print the allocation statistics
+        void printStats( ostream & os )
+        {
+            os<<"Arena: "<<nbAllocations<<" allocations ("<<nbReused<<" reused) "<<nbDeallocations<<" deallocations, "
+              <<bytesUsed<<" bytes used (max "<<maxBytesUsed<<"), "<<bytesReserved()<<" bytes reserved in "<<slabs.size()<<" slabs, "
+              <<nbBigBlocks<<" blocks out of the slabs"<<endl;
+        }
+
+        //! Return the current arena of the thread (0 if there is no arena)
+        static NodeArena * & current()
+        {
+            static thread_local NodeArena * currentArena = 0 ;
+            return currentArena ;
+        }
+
+        //! Class used to change the current arena in a block of code
+        /**
+            The precedent arena is restored at the end of the block.
+            If the arena given is 0, the blocks are allocated with the operator new in the block of code.
+        */
+        class Scope
+        {
+                NodeArena * precedent ;
+            public:
+                Scope( NodeArena * arena ){ precedent = current() ; current() = arena ; }
+                ~Scope(){ current() = precedent ; }
+        };
+
+    private:
+
+        //! Copy is not allowed (the slabs would be released twice)
+        NodeArena( const NodeArena & ) ;
+        NodeArena & operator = ( const NodeArena & ) ;
+};
+
+
+//! Allocator of the STL allocating the memory in the current arena of the thread.
+/**
+    Used for the vectors of the nodes of the tries.
+    \see NodeArena
+*/
+template< class T >
+class ArenaAllocator
+{
+    public:
+
+        typedef T value_type ;
+
+        ArenaAllocator(){}
+
+        template< class U >
+        ArenaAllocator( const ArenaAllocator<U> & ){}
+
+        T * allocate( size_t n ){ return (T*) NodeArena::allocateCurrent( n * sizeof( T ) ) ; }
+
+        void deallocate( T * p, size_t n ){ NodeArena::deallocate( p, n * sizeof( T ) ) ; }
+
+        template< class U >
+        bool operator == ( const ArenaAllocator<U> & ) const { return true ; }
+
+        template< class U >
+        bool operator != ( const ArenaAllocator<U> & ) const { return false ; }
+};
+
+
+//! Vector allocated in the current arena of the thread.
+/**
+    The object and its elements are allocated in the arena.
+    \see NodeArena
+*/
+template< class T >
+class ArenaVector : public vector< T, ArenaAllocator<T> >
+{
+    public:
+
+        typedef vector< T, ArenaAllocator<T> > base ;
+
+        ArenaVector() : base() {}
+
+        explicit ArenaVector( size_t n ) : base( n ) {}
+
+        ArenaVector( size_t n, const T & val ) : base( n, val ) {}
+
+        ArenaVector( const ArenaVector & v ) : base( v ) {}
+
+        ArenaVector & operator = ( const ArenaVector & v ){ base::operator=( v ) ; return (*this) ; }
+
+        static void * operator new( size_t size ){ return NodeArena::allocateCurrent( size ) ; }
+
+        static void operator delete( void * ptr, size_t size ){ NodeArena::deallocate( ptr, size ) ; }
+};
+
+
+#endif
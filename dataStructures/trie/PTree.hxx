@@ -22,6 +22,7 @@
 #define PTREE_HXX
 
 #include "Node.hxx"
+#include "SetIndex.hxx"
 #include "RecodeToInt.hxx"
 #include "Boolean.hpp"
 
@@ -52,23 +53,42 @@ class PTree
     
                 //! Root node of the trie.
                 Node< SetsType, T  > * head;   
+
+                //! Arena where the nodes of the trie are allocated (0 if the nodes are allocated with the operator new)
+                NodeArena * arena ;
                                
    
                 
       public:
             //! recode functor used to recode all the itemsets inserted in int and to keep the original order of the itemsets.
-            static  RecodeToInt<SetsType> recode ;
+            /**
+                The recode functor is shared by all the tries of a same exploration (candidates, borders, transversals...),
+                so that the internal ids are the same in all these tries. It is not deleted by the trie.
+            */
+            RecodeToInt<SetsType> * recode ;
           
+            //! Return the recode functor used by default by the tries created in the current thread.
+            /**
+                Two explorations executed in two different threads do not share their recode functor.
+            */
+            static RecodeToInt<SetsType> * defaultRecode()
+            {
+                static thread_local RecodeToInt<SetsType> threadRecode ;
+                return & threadRecode ;
+            }
             
             //! Used to have the same syntax tha the STL 
             typedef ItPTree<SetsType,T> iterator ;                          
              
             //! Constructor. 
-            PTree( Node< SetsType, T > * inHead = 0, int inSize=0, int inHeight = 0 ) 
-                     : head( inHead ), nbsets( inSize ), height( inHeight ) {}
+            /**
+                \param inRecode recode functor of the trie (if 0, the default recode functor of the current thread is used)
+            */
+            PTree( Node< SetsType, T > * inHead = 0, int inSize=0, int inHeight = 0, RecodeToInt<SetsType> * inRecode = 0 ) 
+                     : head( inHead ), nbsets( inSize ), height( inHeight ), arena( 0 ) { recode = inRecode ? inRecode : defaultRecode() ; }
                      
             //! Copy constructor.         
-        	PTree( const PTree &t ) : head( t.head ), nbsets( t.nbsets ), height( t.height) {}
+        	PTree( const PTree &t ) : head( t.head ), nbsets( t.nbsets ), height( t.height), arena( t.arena ), recode( t.recode ) {}
         	
         	//! Destructor.
         	~PTree()
@@ -86,9 +106,10 @@ class PTree
             template< class Container >
             void push_back(  Container& setElement, T nb = T(1)  )
             { 
+                NodeArena::Scope scope( arena ) ;
                 if( !head ) head = new Node< SetsType, T >(-1) ;
 
-                int length = head->push_back( recode( setElement ) , nb );
+                int length = head->push_back( (*recode)( setElement ) , nb );
 
                 if ( length ) nbsets++ ;  
                 if( height < length ) height = length ;
@@ -106,8 +127,9 @@ class PTree
             template< class InputIterator>
             void push_back( InputIterator  first, InputIterator last, T nb = T(1)  )
             {       
+                 NodeArena::Scope scope( arena ) ;
                  if( !head ) head = new Node< SetsType, T >(-1) ;
-                 int length = head->push_back( recode( first,last)  , nb );                
+                 int length = head->push_back( (*recode)( first,last)  , nb );                
                  if ( length ) nbsets++ ;  
                  if( height < length ) height = length ;
 
@@ -121,6 +143,7 @@ class PTree
             */
             void erase( iterator & position )
             {
+                NodeArena::Scope scope( arena ) ;
 
                 int index = position.ptr->deleteItVect( position.internalId - position.ptr->offset ) ;//the next index
              
@@ -148,7 +171,8 @@ class PTree
             template<  class Container >
             void addToNode( iterator & position, Container& setElement, T nb = T(1)  )
             {                 
-                 position->insertChildNode( position.index+position->getOffset(), recode( setElement ) , nb );                 
+                 NodeArena::Scope scope( arena ) ;
+                 position->insertChildNode( position.index+position->getOffset(), (*recode)( setElement ) , nb );                 
                  
                  int length = position.length + setElement.size() ;
 
@@ -166,7 +190,8 @@ class PTree
             template< class InputIterator>
             void addToNode( iterator & position, InputIterator first, InputIterator last, T nb = T(1) )
             {                  
-                 vector< int > tmpset = recode( first, last );
+                 NodeArena::Scope scope( arena ) ;
+                 vector< int > tmpset = (*recode)( first, last );
 
                  position.ptr->insertChildNode( position.internalId, tmpset  , nb );                 
 
@@ -183,6 +208,7 @@ class PTree
             */    
             iterator eraseNode( iterator & it )
             {                     
+                NodeArena::Scope scope( arena ) ;
                 int index = it.ptr->deleteItVect( it.internalId - it.ptr->offset ) ;//the next index
         
                 if( it.ptr->cnts == 0 ) // if there is no more elements in the node delete the node
@@ -222,7 +248,7 @@ class PTree
             }        
                                                          
             //! Return an iterator on the first leaf of the trie (exploring the trie from the left to the right). 
-            ItPTree< SetsType, T > beginLeaf() { return ItPTree< SetsType, T >( head, &recode ); }                                                                                                      
+            ItPTree< SetsType, T > beginLeaf() { return ItPTree< SetsType, T >( head, recode ); }                                                                                                      
 
             //! Return an iterator on the first leaf of the trie (exploring the trie from the right to the left). 
             ItPTree< SetsType, T > rbeginLeaf() 
@@ -231,7 +257,7 @@ class PTree
                 it.ptr = head;
                 
                 it.internalId= head->cnts->size()+head->offset;
-                it.recode = &recode ;
+                it.recode = recode ;
                 it.height = 1 ;
                 it.internalset=0;
                 it.set=0; 
@@ -248,7 +274,7 @@ class PTree
                 it.ptr = head;
                 
                 it.internalId= -1;
-                it.recode = &recode ;
+                it.recode = recode ;
                 it.height = 0 ;
                 it.internalset=0;
                 it.set=0;                     
@@ -308,7 +334,7 @@ class PTree
 
         	//! Affectation operator.
         	PTree & operator = ( const PTree & inPTree ) 
-        	{ if( head ) delete head ; head = inPTree.head ; nbsets = inPTree.nbsets ; height = inPTree.height; }
+        	{ if( head ) delete head ; head = inPTree.head ; nbsets = inPTree.nbsets ; height = inPTree.height; recode = inPTree.recode; arena = inPTree.arena; return (*this) ; }
             
         	//! Operator < to process itemsets near the positive border
         	bool operator<(const PTree & inTrie ) const{return height < inTrie.height;}
@@ -324,6 +350,29 @@ class PTree
 
         	//! Initialize the root node
         	void setHead( Node< SetsType, T >* inHead ){ head = inHead ; }
+
+        	//! Initialize the recode functor (to share it with other tries)
+        	void setRecode( RecodeToInt<SetsType> * inRecode ){ recode = inRecode ; }
+
+        	//! Initialize the arena where the nodes are allocated (0 to allocate them with the operator new)
+        	/**
+        	    Must be called when the trie is empty.
+        	*/
+        	void setArena( NodeArena * inArena ){ arena = inArena ; }
+
+        	//! Return the arena where the nodes are allocated
+        	NodeArena * getArena() const { return arena ; }
+
+        	//! Release all the nodes of the trie at once (without deleting them one by one).
+        	/**
+        	    Only valid if the arena is used by this trie only, else the nodes of the other tries are released too.
+        	    If the trie has no arena, the nodes are deleted as in deleteChildren().
+        	*/
+        	void release()
+        	{
+        	    if( arena ){ head = 0 ; nbsets = 0 ; height = 0 ; arena->release() ; }
+        	    else deleteChildren() ;
+        	}
         	
         	//! Initialize the height of the tree 
         	void setHeight( int inHeight ) { height = inHeight; }
@@ -349,6 +398,7 @@ class PTree
         	Node< SetsType, T > * insert( int * itemset, int level, T inSup = T(true) )
     	    { 
                 Node< SetsType, T > * last = 0;         
+                NodeArena::Scope scope( arena ) ;
                 if( !head ) head = new Node< SetsType, T >(-1) ;
                 if( last = head->insert( itemset, level, inSup) )
                 { nbsets++ ;  if( height < level ) height = level  ;  }
@@ -358,6 +408,7 @@ class PTree
         	Node< SetsType, T > * insert( vectUI * itemset, T inSup = T(true) ) 
   	        { 
                 Node< SetsType, T > * last = 0; 
+                NodeArena::Scope scope( arena ) ;
                 if( !head ) head = new Node< SetsType, T >(-1) ;
                 if( last = head->insert( itemset, inSup ) )
                 { nbsets++ ; if( height < itemset->size() ) height = itemset->size() ;  }
@@ -367,6 +418,7 @@ class PTree
         	Node< SetsType, T > * insert( list< int > * itemset, T inSup = T(true) )
   	        { 
                 Node< SetsType, T > * last = 0; 
+                NodeArena::Scope scope( arena ) ;
                 if( !head ) head = new Node< SetsType, T >(-1) ;
                 if( last = head->insert( itemset, inSup ) )
                 { nbsets++ ;  if( height < itemset->size() ) height = itemset->size() ;  }
@@ -380,7 +432,7 @@ class PTree
         	// ---------------------------------------------------
         
         	void deleteIt( vectUI * itemset ) 
-                { if( head ) if( head->deleteIt( itemset ) ) nbsets--;  }
+                { NodeArena::Scope scope( arena ) ; if( head ) if( head->deleteIt( itemset ) ) nbsets--;  }
         		
             // -----------------------------------------------------
         	// print to screen all the itemset stored in sub tree
@@ -388,7 +440,7 @@ class PTree
         	// ----------------------------------------------------
         
         	void print()
-        	   { if( head ) head->print( &recode ) ; }
+        	   { if( head ) head->print( recode ) ; }
         	   
         	// ----------------------------------------------------
         	// print to screen all the supersets stored in sub tree
@@ -397,7 +449,7 @@ class PTree
            	// ----------------------------------------------------
         
         	void printSupersets()
-        	   { if( head ) head->printSupersets( &recode ) ; }   
+        	   { if( head ) head->printSupersets( recode ) ; }   
         
         	// ---------------------------------------------------
         	// read from a file all the itemset and stored them 
@@ -417,7 +469,7 @@ class PTree
         	   { if( head ) head->saveItemsets( fileName, remap ) ; }
         	
             void save( const char * fileName )
-        	   { if( head ) head->save( fileName, &recode ) ; }   
+        	   { if( head ) head->save( fileName, recode ) ; }   
         	
             // ---------------------------------------------------
         	// save into a file all the itemset stored in tree
@@ -484,10 +536,10 @@ class PTree
         	// minimals transversals
         	// ----------------------------------------------------
         
-        	PTree * newItTr( PTree * bi, vectUI * itemset, PTree * freqTr = 0 ) ;
+        	PTree * newItTr( PTree * bi, vectUI * itemset, PTree * freqTr = 0, SetIndex< SetsType, T > * indexFreqTr = 0 ) ;
         
-        	void newItTr( Node< SetsType, T > * currNode, vectUI * itemset, 
-                          list< int > * lst, PTree * res, PTree * freqTr = 0 ) ;
+        	void newItTr( Node< SetsType, T > * currNode, vectUI * itemset, list< int > * lst, PTree * res, 
+                          PTree * freqTr, SetIndex< SetsType, T > * indexTr, SetIndex< SetsType, T > * indexFreqTr ) ;
         
         	// -------------------------------------------------
         	// method merging this sets of itemset 
@@ -518,7 +570,7 @@ class PTree
         	// minimals transversals
         	// -------------------------------------------------------------
         
-        	void trMinIopt( vectUI * itemset, int  maxTrans, PTree * freqTr=0  );
+        	void trMinIopt( vectUI * itemset, int  maxTrans, PTree * freqTr=0, SetIndex< SetsType, T > * indexFreqTr=0  );
         
         	// -------------------------------------------------------------
         	// method which calcul the minimal transversal with the edges
@@ -540,15 +592,19 @@ class PTree
         	
 
         	
-        	void trMinIopt(  Node< SetsType, T > * currNode, int & maxTrans, PTree * freqTr, vectUI * vect  );
+        	void trMinIopt(  Node< SetsType, T > * currNode, int & maxTrans, PTree * freqTr, vectUI * vect, SetIndex< SetsType, T > * indexFreqTr  );
         	
         	template< class IteratorsContainer>
         	void trMinIopt( IteratorsContainer & listEdge, int  maxTrans, PTree * freqTr=0  )
         	{
+                 // freqTr is not modified by the dualization, so it is indexed only once
+                 SetIndex< SetsType, T > indexFreqTr ;
+                 if( freqTr )
+                     indexFreqTr.insert( *freqTr ) ;
            
                  for( typename IteratorsContainer::iterator it = listEdge.begin(); it != listEdge.end() ; ++it )
                  {
-                      trMinIopt( it->getInternalset()   , maxTrans, freqTr ) ;
+                      trMinIopt( it->getInternalset()   , maxTrans, freqTr, &indexFreqTr ) ;
                  }
                  
             }
@@ -579,9 +635,9 @@ class PTree
                     PTree * res = 0;         	    
                     if( head )
                     {
-                         res = new PTree(0, nbsets) ; 
+                         res = new PTree(0, nbsets, 0, recode) ; 
                          res->height = 0;
-                         res->head = head->complem( recode( listElem), res->height  ) ;  
+                         res->head = head->complem( (*recode)( listElem), res->height  ) ;  
                          
                     }
                     return res ;
@@ -607,7 +663,7 @@ class PTree
         
         	PTree * genSubsets( int inSize ) 
         	    { PTree * res = 0; 
-                  if( head ){ res = new PTree() ; res->head = head->genSubsets( inSize ) ;  res->height = inSize ; }
+                  if( head ){ res = new PTree(0, 0, 0, recode) ; res->head = head->genSubsets( inSize ) ;  res->height = inSize ; }
                   return res ;
                 }
                 
@@ -617,8 +673,6 @@ class PTree
 
 };
 
-template< class SetsType, class T> RecodeToInt<SetsType> PTree< SetsType, T >::recode = RecodeToInt<SetsType>() ;
-
 // ---------------------------------------------------------------------------------------------- 
 
 /**
@@ -745,19 +799,27 @@ bool PTree< SetsType, T >::initTrBiOpt( Node< SetsType, T >* currNode, vectUI *
 *  minimals transversals
 */
 template< class SetsType, class T>
-PTree< SetsType, T > * PTree< SetsType, T >::newItTr( PTree< SetsType, T > * bi, vectUI * itemset, PTree< SetsType, T > * freqTr ) 
+PTree< SetsType, T > * PTree< SetsType, T >::newItTr( PTree< SetsType, T > * bi, vectUI * itemset, PTree< SetsType, T > * freqTr, SetIndex< SetsType, T > * indexFreqTr ) 
 {
 	PTree< SetsType, T > * res ;		
 
 	list< int > * lst ;
 
-	res = new PTree< SetsType, T >() ;
+	res = new PTree< SetsType, T >( 0, 0, 0, recode ) ;
 
 	lst = new list< int >() ;
 
 	if( bi->head )
 	{	    
-		newItTr( bi->head, itemset, lst, res, freqTr ) ;	
+	    // the inclusion tests of the new itemsets in this set are done with an index of its sets,
+	    // if there are more tests than sets to index (else the trie is explored for each test)
+	    SetIndex< SetsType, T > * indexTr = 0 ;
+	    if( bi->nbsets * itemset->size() > nbsets )
+	        indexTr = new SetIndex< SetsType, T >( *this ) ;
+	        
+		newItTr( bi->head, itemset, lst, res, freqTr, indexTr, indexFreqTr ) ;	
+		
+		delete indexTr ;
 	}	
     else
     {
@@ -774,7 +836,8 @@ PTree< SetsType, T > * PTree< SetsType, T >::newItTr( PTree< SetsType, T > * bi,
 
 template< class SetsType, class T>
 void PTree< SetsType, T >::newItTr( Node< SetsType, T > * currNode, vectUI * itemset, 
-                    list< int > * lst, PTree< SetsType, T > * res, PTree< SetsType, T > * freqTr  ) 
+                    list< int > * lst, PTree< SetsType, T > * res, PTree< SetsType, T > * freqTr, 
+                    SetIndex< SetsType, T > * indexTr, SetIndex< SetsType, T > * indexFreqTr  ) 
 {	
 
 	list< int >::iterator tmpl ;
@@ -793,7 +856,7 @@ void PTree< SetsType, T >::newItTr( Node< SetsType, T > * currNode, vectUI * ite
    
        		if( currNode->getChilds() && i < currNode->getChilds()->size() && (* currNode->getChilds() )[ i ] )
             {	
-       		    newItTr( (*currNode->getChilds() )[ i ], itemset, lst, res, freqTr ) ;
+       		    newItTr( (*currNode->getChilds() )[ i ], itemset, lst, res, freqTr, indexTr, indexFreqTr ) ;
    		    
 	        }    
        		else // we have check all the items of the current itemset strored in vect
@@ -814,8 +877,8 @@ void PTree< SetsType, T >::newItTr( Node< SetsType, T > * currNode, vectUI * ite
                       
         			// we test that all the itemsets of Si are not inluded into our candidate
 
-        			if ( ( includedIn( lst ) == false )
-        				 && ( ( freqTr == 0 ) ||( freqTr->includedIn( lst ) == false ) ) 
+        			if ( ( ( indexTr ? indexTr->includedIn( lst ) : includedIn( lst ) ) == false )
+        				 && ( ( freqTr == 0 ) || ( ( indexFreqTr ? indexFreqTr->includedIn( lst ) : freqTr->includedIn( lst ) ) == false ) ) 
                         )        		
              
                         res->insert( lst ) ;     
@@ -849,13 +912,13 @@ void PTree< SetsType, T >::newItTr( Node< SetsType, T > * currNode, vectUI * ite
 *  minimals transversals
 */
 template< class SetsType, class T>
-void PTree< SetsType, T >::trMinIopt( vectUI * itemset, int maxTrans, PTree< SetsType, T > * freqTr )
+void PTree< SetsType, T >::trMinIopt( vectUI * itemset, int maxTrans, PTree< SetsType, T > * freqTr, SetIndex< SetsType, T > * indexFreqTr )
 {
 	PTree< SetsType, T > * bi ;
 
 	PTree< SetsType, T > * res ;
 	
-	bi = new PTree< SetsType, T >() ;
+	bi = new PTree< SetsType, T >( 0, 0, 0, recode ) ;
 
 	// construction of Si and Bi
 	// Si is stored into this set
@@ -872,7 +935,7 @@ void PTree< SetsType, T >::trMinIopt( vectUI * itemset, int maxTrans, PTree< Set
 	// of itemset,
 	// this set of itemset is returned by the method
 
-	res = newItTr( bi, itemset,  freqTr ) ;
+	res = newItTr( bi, itemset,  freqTr, indexFreqTr ) ;
 
 	delete bi;
 	
@@ -913,14 +976,19 @@ void PTree< SetsType, T >::trMinIopt( PTree< SetsType, T > * tr, int maxTrans, P
 
 	vect = new vectUI ;
 
+	// freqTr is not modified by the dualization, so it is indexed only once
+	SetIndex< SetsType, T > indexFreqTr ;
+	if( freqTr )
+	    indexFreqTr.insert( *freqTr ) ;
+
 	if(  tr->head ) 
-		trMinIopt( tr->head, maxTrans, freqTr, vect ) ;
+		trMinIopt( tr->head, maxTrans, freqTr, vect, &indexFreqTr ) ;
 	
 	delete vect ;
 }
 
 template< class SetsType, class T>
-void PTree< SetsType, T >::trMinIopt(  Node< SetsType, T > * currNode, int & maxTrans, PTree< SetsType, T > * freqTr, vectUI * vect  ) 
+void PTree< SetsType, T >::trMinIopt(  Node< SetsType, T > * currNode, int & maxTrans, PTree< SetsType, T > * freqTr, vectUI * vect, SetIndex< SetsType, T > * indexFreqTr  ) 
 {   
 	for( int i = 0; i < currNode->getCnts() ->size(); i++)
 	{
@@ -935,12 +1003,12 @@ void PTree< SetsType, T >::trMinIopt(  Node< SetsType, T > * currNode, int & max
        		if( currNode->getChilds() && i < currNode->getChilds()->size() 
                            && (* currNode->getChilds() )[ i ] )
             {	
-       		    trMinIopt( (* currNode->getChilds() )[ i ], maxTrans, freqTr, vect ) ;
+       		    trMinIopt( (* currNode->getChilds() )[ i ], maxTrans, freqTr, vect, indexFreqTr ) ;
 	        }    
        		else // we have check all the items of the current itemset strored in vect
                  // so we insert the new edge in the hypergraph
         	{                 
-        		trMinIopt( vect, maxTrans, freqTr ) ;	
+        		trMinIopt( vect, maxTrans, freqTr, indexFreqTr ) ;	
            	}    
                                 
    		vect->pop_back() ;
@@ -968,7 +1036,7 @@ PTree< SetsType, T > * PTree< SetsType, T >::trMinOpt( int  minEdge, int  maxTra
 
 	vectUI * vect ;
 
-	res = new PTree< SetsType, T >() ;
+	res = new PTree< SetsType, T >( 0, 0, 0, recode ) ;
 	
 	vect = new vectUI() ;
 
@@ -1025,7 +1093,7 @@ void PTree< SetsType, T >::trMinOpt( Node< SetsType, T > * currNode,  PTree< Set
               
                 		res->head = new Node< SetsType, T >(0, (*vect)[0],0,0 ) ;
                 		
-                 		res->head->setCnts( new vector< T >( (*vect)[ vect->size()-1 ] - (*vect)[0] +1 )  ) ;
+                 		res->head->setCnts( new typename Node< SetsType, T >::vectT( (*vect)[ vect->size()-1 ] - (*vect)[0] +1 )  ) ;
                 
                 		for( int i= 0; i < vect->size(); i++ )            		
                 		    res->head->setCnt( (*vect)[i] - res->head->getOffset() , 1 )	;
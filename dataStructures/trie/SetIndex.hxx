@@ -0,0 +1,350 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef SETINDEX_HXX
+#define SETINDEX_HXX
+
+#include <vector>
+
+#include "Node.hxx"
+
+using namespace std;
+
+//! Index of a set of sets, used to answer the inclusion queries of the tries (PTree::include and PTree::includedIn) without exploring the trie.
+/**
+   Each set is stored in a bitset (wrt the internal id of the elements), and two inverted lists are stored for each element:
+   the sets containing the element, and the sets whose first (smallest) element is this element.
+       * to know if a set X is included in one of the sets, only the sets of the shortest inverted list of the elements of X are tested.
+       * to know if one of the sets is included in X, only the sets whose first element is in X are tested (each set is tested at most once).
+   Each test is an inclusion test on bitsets.
+
+   The sets indexed from a trie are its leaves (as for the inclusion tests of the nodes).
+   The index is not updated when the trie is modified.
+
+   The template parameter SetsType is the type of the elements of the tries.
+   The template parameter T is the type of the measure of the tries.
+*/
+template< class SetsType, class T >
+class SetIndex
+{
+        //! Type of the words of the bitsets
+        typedef unsigned long long Word ;
+
+        //! Type of a bitset
+        typedef vector< Word > Bitset ;
+
+        //! Number of bits in a word
+        static const int wordSize = 8 * sizeof( Word ) ;
+
+        //! the sets
+        vector< Bitset > sets ;
+
+        //! the sets containing each element
+        vector< vector< int > > occ ;
+
+        //! the sets whose first element is each element
+        vector< vector< int > > first ;
+
+        //! bitset of the set of the current query
+        Bitset query ;
+
+        //! Store a set in the bitset of the queries
+        template< class Container >
+        void setQuery( Container & itemset )
+        {
+             query.assign( occ.size() / wordSize + 1, 0 ) ;
+             for( typename Container::iterator it = itemset.begin() ; it != itemset.end() ; ++it )
+                  if( *it < occ.size() )
+                      query[ *it / wordSize ] |= ( (Word) 1 ) << ( *it % wordSize ) ;
+        }
+
+        //! Return true if b1 is included in b2 (the missing words are 0)
+        static bool included( const Bitset & b1, const Bitset & b2 )
+        {
+             for( int w = 0 ; w < b1.size() ; w++ )
+                  if( b1[ w ] & ~( w < b2.size() ? b2[ w ] : 0 ) )
+                      return false ;
+             return true ;
+        }
+
+        //! Insert the leaves of a trie
+        /**
+            \param currNode current node of the trie
+            \param vect the elements of the current node
+        */
+        void insert( Node< SetsType, T > * currNode, vectUI & vect ) ;
+
+        //! Search the sets of a trie included in one of the sets of the index
+        /**
+            \param currNode current node of the trie
+            \param vect the elements of the current node
+            \param res the sets found
+        */
+        void searchIncluded( Node< SetsType, T > * currNode, vectUI & vect, vector< vectUI > & res ) ;
+
+    public:
+
+        //! Constructor of an empty index
+        SetIndex(){}
+
+        //! Constructor of the index of the leaves of a trie
+        /**
+            \param trie the trie
+        */
+        template< class Trie >
+        SetIndex( Trie & trie ){ insert( trie ) ; }
+
+        //! Insert a set in the index
+        /**
+            \param itemset the set (internal ids, in increasing order)
+        */
+        void insert( vectUI & itemset ) ;
+
+        //! Insert the leaves of a trie in the index
+        /**
+            \param trie the trie
+        */
+        template< class Trie >
+        void insert( Trie & trie )
+        {
+            vectUI vect ;
+            if( trie.getHead() )
+                insert( trie.getHead(), vect ) ;
+        }
+
+        //! Return the number of sets of the index
+        int size(){ return sets.size() ; }
+
+        //! Return true if a set is included in one of the sets of the index (same as PTree::include)
+        /**
+            \param itemset the set (internal ids)
+        */
+        bool include( vectUI * itemset ) ;
+
+        //! Return true if one of the sets of the index is included in a set (same as PTree::includedIn)
+        /**
+            \param itemset the set (internal ids)
+        */
+        template< class Container >
+        bool includedIn( Container * itemset ) ;
+
+        //! Return true if a set is included in one of the sets of a list
+        /**
+            Used for the progressive focusing of the inclusion tests: the list only contains the sets which can include the set
+            (for example the sets containing its prefix, see select()).
+            \param itemset the set (internal ids)
+            \param ids the index of the sets to test
+        */
+        bool include( vectUI * itemset, vector< int > & ids )
+        {
+            for( int i = 0 ; i < itemset->size() ; i++ )
+                 if( (*itemset)[ i ] >= (int) occ.size() )
+                     return false ;
+
+            setQuery( *itemset ) ;
+
+            for( int s = 0 ; s < ids.size() ; s++ )
+                 if( included( query, sets[ ids[ s ] ] ) )
+                     return true ;
+
+            return false ;
+        }
+
+        //! Select in a list the sets containing some elements
+        /**
+            \param ids the index of the sets
+            \param elements the elements (internal ids)
+            \param res the index of the sets of ids containing all the elements
+        */
+        void select( vector< int > & ids, vectUI & elements, vector< int > & res )
+        {
+            res.resize( 0 ) ;
+
+            for( int s = 0 ; s < ids.size() ; s++ )
+            {
+                 Bitset & set = sets[ ids[ s ] ] ;
+                 bool all = true ;
+
+                 for( int e = 0 ; e < elements.size() && all ; e++ )
+                      all = elements[ e ] / wordSize < set.size() && ( set[ elements[ e ] / wordSize ] >> ( elements[ e ] % wordSize ) ) & 1 ;
+
+                 if( all )
+                     res.push_back( ids[ s ] ) ;
+            }
+        }
+
+        //! Erase from a trie all the sets included in one of the sets of the index
+        /**
+            \param trie the trie
+            \return the number of sets erased
+        */
+        template< class Trie >
+        int eraseIncluded( Trie & trie )
+        {
+            vector< vectUI > res ;
+            vectUI vect ;
+
+            if( trie.getHead() && sets.size() )
+                searchIncluded( trie.getHead(), vect, res ) ;
+
+            for( int i = 0 ; i < res.size() ; i++ )
+                 trie.deleteIt( &res[ i ] ) ;
+
+            return res.size() ;
+        }
+};
+
+//! Insert a set in the index
+/**
+    \param itemset the set (internal ids, in increasing order)
+*/
+template< class SetsType, class T >
+void SetIndex< SetsType, T >::insert( vectUI & itemset )
+{
+    if( itemset.empty() )
+        return ;
+
+    int id = sets.size() ;
+
+    if( itemset.back() >= (int) occ.size() )
+    {
+        occ.resize( itemset.back() + 1 ) ;
+        first.resize( itemset.back() + 1 ) ;
+    }
+
+    sets.push_back( Bitset( itemset.back() / wordSize + 1, 0 ) ) ;
+
+    for( int i = 0 ; i < itemset.size() ; i++ )
+    {
+         sets.back()[ itemset[ i ] / wordSize ] |= ( (Word) 1 ) << ( itemset[ i ] % wordSize ) ;
+         occ[ itemset[ i ] ].push_back( id ) ;
+    }
+
+    first[ itemset[ 0 ] ].push_back( id ) ;
+}
+
+//! Insert the leaves of a trie
+/**
+    \param currNode current node of the trie
+    \param vect the elements of the current node
+*/
+template< class SetsType, class T >
+void SetIndex< SetsType, T >::insert( Node< SetsType, T > * currNode, vectUI & vect )
+{
+    for( int i = 0; currNode->getCnts() && i < currNode->getCnts()->size(); i++ )
+    {
+        if( currNode->existVal( i ) )
+        {
+            vect.push_back( i + currNode->getOffset() ) ;
+
+            if( currNode->getChilds() && i < currNode->getChilds()->size() && (* currNode->getChilds() )[ i ] )
+                insert( (* currNode->getChilds() )[ i ], vect ) ;
+            else
+                insert( vect ) ;
+
+            vect.pop_back() ;
+        }
+    }
+}
+
+//! Return true if a set is included in one of the sets of the index (same as PTree::include)
+/**
+    \param itemset the set (internal ids)
+*/
+template< class SetsType, class T >
+bool SetIndex< SetsType, T >::include( vectUI * itemset )
+{
+    if( itemset->empty() )
+        return sets.size() ;
+
+    // the shortest inverted list
+    vector< int > * shortest = 0 ;
+
+    for( int i = 0 ; i < itemset->size() ; i++ )
+    {
+         if( (*itemset)[ i ] >= (int) occ.size() || occ[ (*itemset)[ i ] ].empty() )
+             return false ;
+
+         if( ! shortest || occ[ (*itemset)[ i ] ].size() < shortest->size() )
+             shortest = & occ[ (*itemset)[ i ] ] ;
+    }
+
+    setQuery( *itemset ) ;
+
+    for( int s = 0 ; s < shortest->size() ; s++ )
+         if( included( query, sets[ (*shortest)[ s ] ] ) )
+             return true ;
+
+    return false ;
+}
+
+//! Return true if one of the sets of the index is included in a set (same as PTree::includedIn)
+/**
+    \param itemset the set (internal ids)
+*/
+template< class SetsType, class T > template< class Container >
+bool SetIndex< SetsType, T >::includedIn( Container * itemset )
+{
+    setQuery( *itemset ) ;
+
+    for( typename Container::iterator it = itemset->begin() ; it != itemset->end() ; ++it )
+    {
+         if( *it >= (int) first.size() )
+             continue ;
+
+         vector< int > & candidates = first[ *it ] ;
+
+         for( int s = 0 ; s < candidates.size() ; s++ )
+              if( included( sets[ candidates[ s ] ], query ) )
+                  return true ;
+    }
+
+    return false ;
+}
+
+//! Search the sets of a trie included in one of the sets of the index
+/**
+    \param currNode current node of the trie
+    \param vect the elements of the current node
+    \param res the sets found
+*/
+template< class SetsType, class T >
+void SetIndex< SetsType, T >::searchIncluded( Node< SetsType, T > * currNode, vectUI & vect, vector< vectUI > & res )
+{
+    for( int i = 0; currNode->getCnts() && i < currNode->getCnts()->size(); i++ )
+    {
+        if( currNode->existVal( i ) )
+        {
+            vect.push_back( i + currNode->getOffset() ) ;
+
+            if( currNode->getChilds() && i < currNode->getChilds()->size() && (* currNode->getChilds() )[ i ] )
+            {
+                if( include( &vect ) ) // else the sets of the child node cannot be included
+                    searchIncluded( (* currNode->getChilds() )[ i ], vect, res ) ;
+            }
+            else if( include( &vect ) )
+                res.push_back( vect ) ;
+
+            vect.pop_back() ;
+        }
+    }
+}
+
+#endif
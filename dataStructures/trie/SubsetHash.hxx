@@ -0,0 +1,147 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef SUBSETHASH_HXX
+#define SUBSETHASH_HXX
+
+#include <unordered_set>
+
+using namespace std;
+
+//! Hash index of the sets of a given size of a trie, used to test the subsets of the candidates without exploring the trie.
+/**
+   Each set is stored as a key of 64 bits, where the internal ids of its elements are packed in the order of the trie.
+   The index can only be used if the internal ids of a set fit in a key (ie length * number of bits of an id <= 64),
+   else init() returns false and the subsets must be searched in the trie.
+
+   The index is not updated when the trie is modified, it is filled by the algorithm for one level and then cleared.
+*/
+class SubsetHash
+{
+        //! Type of the keys
+        typedef unsigned long long Key ;
+
+        //! the keys of the sets
+        unordered_set< Key > sets ;
+
+        //! number of bits of an internal id in a key
+        int bits ;
+
+        //! size of the sets of the index (0 if the index is not used)
+        int length ;
+
+        //! Return the key of the set ending at the node pointed by an iterator, and its size
+        template< class Iterator >
+        Key key( Iterator it, int & size )
+        {
+            Key k = 0 ;
+            size = 0 ;
+
+            for( ; it != Iterator() && it.elementId() != -1 ; it = it.parentNode() )
+            {
+                 k |= ( (Key) it.elementId() ) << ( bits * size ) ;
+                 size++ ;
+            }
+
+            return k ;
+        }
+
+    public:
+
+        //! Constructor of an index not used
+        SubsetHash(){ bits = 0 ; length = 0 ; }
+
+        //! Initialize the index for the sets of a given size (the index is emptied)
+        /**
+            \param inlength size of the sets of the index
+            \param maxId greatest internal id of the elements
+            \return false if the sets cannot be packed in a key (the index is not used)
+        */
+        bool init( int inlength, int maxId )
+        {
+            clear() ;
+
+            bits = 1 ;
+            while( bits < 64 && ( 1ULL << bits ) <= (Key) maxId )
+                   bits++ ;
+
+            if( inlength < 1 || bits * inlength > 64 )
+                return false ;
+
+            length = inlength ;
+            return true ;
+        }
+
+        //! Empty the index and free its memory (the index is not used anymore)
+        void clear(){ unordered_set< Key >().swap( sets ) ; length = 0 ; }
+
+        //! Exchange the sets of two indexes
+        void swap( SubsetHash & index ){ sets.swap( index.sets ) ; std::swap( bits, index.bits ) ; std::swap( length, index.length ) ; }
+
+        //! Return the size of the sets of the index (0 if the index is not used)
+        int setsLength(){ return length ; }
+
+        //! Return the number of sets of the index
+        int size(){ return sets.size() ; }
+
+        //! Insert the set ending at the node pointed by an iterator (it is ignored if its size is not the size of the index)
+        template< class Iterator >
+        void insert( Iterator it )
+        {
+            int size ;
+            Key k = key( it, size ) ;
+
+            if( length && size == length )
+                sets.insert( k ) ;
+        }
+
+        //! Test if the subsets of a set generated using the elements pointed by itPref and itLast are in the index.
+        /**
+            itPref and itLast have the same parent node, and itPref points to a set of the index.
+            The two subsets obtained by removing itPref or itLast are not tested (they are in the trie),
+            the others are tested with one probe each.
+            \param itPref iterator on the prefix of the set to test.
+            \param itLast iterator on the element to add to form the candidate set.
+            \return true if all the subsets of size length are in the index.
+        */
+        template< class Iterator >
+        bool testSubsets( Iterator & itPref, Iterator & itLast )
+        {
+            int m ; // number of elements before the two last ones
+            Key prefix = key( itPref.parentNode(), m ) ;
+
+            Key last = ( ( (Key) itPref.elementId() ) << bits ) | (Key) itLast.elementId() ;
+
+            for( int j = 0 ; j < m ; j++ ) // the subset without the j-th element of the prefix (from the end)
+            {
+                 Key low = j ? prefix & ( ( 1ULL << ( bits * j ) ) - 1 ) : 0 ;
+                 Key high = prefix >> ( bits * ( j + 1 ) ) ;
+
+                 Key k = ( ( ( high << ( bits * j ) ) | low ) << ( 2 * bits ) ) | last ;
+
+                 if( ! sets.count( k ) )
+                     return false ;
+            }
+
+            return true ;
+        }
+};
+
+#endif
@@ -54,6 +54,43 @@ class Tatree_base
         
         //! number of elements in the trie
         int nbSets;
+        
+        //! Insert in a new trie the sets stored from a node, with the elements kept.
+        /**
+            The number of sets ending at a node is its number of sets minus the number of sets of its child nodes.
+            \param currNode the curent node
+            \param newRoot root node of the new trie
+            \param setElement the elements kept from the root node to the curent node
+            \param keep keep[ e ] is true if the element e is kept
+            \param minLength the sets with less elements kept are not inserted
+        */
+        template< class Container >
+        void reduce( TatreeNode<SetsType> * currNode, TatreeNode<SetsType> * newRoot, vector<SetsType> & setElement, Container & keep, int minLength )
+        {
+            int nb = currNode->number() ;
+            
+            for( typename map< SetsType, TatreeNode<SetsType> * >::iterator it = currNode->items.begin(); it != currNode->items.end(); it++ )
+            {
+                if( it->second )
+                {
+                    nb -= it->second->number() ;
+                    
+                    if( keep[ it->first ] )
+                        setElement.push_back( it->first ) ;
+                    
+                    reduce( it->second, newRoot, setElement, keep, minLength ) ;
+                    
+                    if( keep[ it->first ] )
+                        setElement.pop_back() ;
+                }
+            }
+            
+            if( currNode != root && nb > 0 && (int) setElement.size() >= minLength )
+            {
+                newRoot->push_back( setElement, nb ) ;
+                nbSets = nbSets + nb ;
+            }
+        }
                     
     public:
         
@@ -122,9 +159,35 @@ class Tatree_base
         } 
         
         void setRecode( RecodeToInt<SetsType> * inrecode ) { recode =inrecode; }
+        
+        //! Reduce the trie: delete some elements from the sets, and the sets becoming too small.
+        /**
+            The trie is rebuilt with the sets filtered (the elements are not recoded again).
+            The template parameter represents a container of booleans indexed by the elements.
+            \param keep keep[ e ] is true if the element e is kept in the sets
+            \param minLength the sets with less elements kept are deleted
+        */
+        template< class Container >
+        void reduce( Container & keep, int minLength )
+        {
+            if( ! root )
+                return ;
+            
+            TatreeNode<SetsType> * newRoot = new TatreeNode<SetsType>() ;
+            vector<SetsType> setElement ;
+            
+            nbSets = 0 ;
+            reduce( root, newRoot, setElement, keep, minLength ) ;
+            
+            delete root ;
+            root = newRoot ;
+        }
       
         //! Function that returns the number of sets in the trie 
         int size(){ return nbSets; }
+        
+        //! Return the root node
+        TatreeNode<SetsType> * getRoot(){ return root ;}
       
         //! Return an iterator on the root node. 
         ItTatree_base<SetsType> begin() { return ItTatree_base<SetsType>( this );  }
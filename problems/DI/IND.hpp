@@ -46,7 +46,7 @@ class UnaryIND
             UnaryIND( const UnaryIND & indi){ left = indi.left; right = indi.right; }
                                
             //! Operator = overloading
-            UnaryIND & operator = ( const UnaryIND & indi ){left = indi.left; right = indi.right; }  
+            UnaryIND & operator = ( const UnaryIND & indi ){left = indi.left; right = indi.right; return *this; }  
             
             //! Equality operator overloading
             bool operator == (const UnaryIND & indi )const{ return( indi.left == left &&  indi.right == right) ; }                                      
@@ -0,0 +1,177 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef INITIND_INDEX_HXX
+#define INITIND_INDEX_HXX
+
+#include <utility>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+
+#include "IND.hpp"
+#include "Boolean.hpp"
+#include "RecodeToInt.hxx"
+
+
+//! Functor used to intialize the IND mining with the satisfied unary IND only.
+/**
+   This functor is used to search the attributes of the relations and to construct the initial set of unary INDs,
+   as InitIND, but only the satisfied unary INDs are inserted in listElements.
+
+   The unary INDs are found with an inverted index, in one scan of each relation (as in SPIDER or in the approach of De Marchi et al.):
+       * for each value of the second relation, the set of the attributes containing this value is computed.
+       * for each attribute A of the first relation, the set of the attributes of the second relation containing all the values of A
+         is the intersection of the sets of its values.
+   The values of the two relations must be recoded with the same recode functor (as for SatisfiedIND).
+
+   The satisfied unary INDs are stored in the predicate (SatisfiedIND::unarySatisfied), so that the algorithm does not test them again.
+   The unary INDs not satisfied are stored in listNotSatisfied: they are not candidates of the algorithm,
+   so they must be added to its negative border with outputNotSatisfied().
+
+   The template parameter Data is the type of the tablular data.
+   The template parameter InputDBFormat is the type of the database.
+   The template parameter Predicate is the type of the predicate (SatisfiedIND).
+   \see InitIND
+*/
+template< class Data, class InputDBFormat, class Predicate >
+class InitIND_Index
+{
+
+    protected:
+
+        //! The first input relational data
+        InputDBFormat * input1 ;
+
+        //! The second input relational data
+        InputDBFormat * input2 ;
+
+        //! the first relation
+        Data * table1 ;
+
+        //! the second relation
+        Data * table2 ;
+
+        //! The predicate
+        Predicate * pred ;
+
+    public:
+
+        //! list of the satisfied unary IND
+        deque<IND> listElements;
+
+        //! list of the unary IND not satisfied
+        deque<IND> listNotSatisfied;
+
+        //! Constructor
+        /*!
+            \param intable1 data of the first relation/table studied
+            \param ininput1 file containing the first relation/table studied
+            \param intable2 data of the second relation/table studied
+            \param ininput2 file containing the second relation/table studied
+            \param inpred the predicate
+        */
+        InitIND_Index( Data & intable1, InputDBFormat &  ininput1, Data & intable2, InputDBFormat &  ininput2, Predicate & inpred )
+        {
+            table1 = &intable1; input1 = &ininput1;
+            table2 = &intable2; input2 = &ininput2;
+            pred = &inpred;
+        }
+
+        //! Execute the initialization of the basic word of the language (the di of size 1) in the algorithm
+        void operator() ();
+
+        //! Output the unary INDs not satisfied in the negative border found by the algorithm (bottom up exploration)
+        /**
+            \param bdN output the negative border in the given objet (must have a push_back( container, measure ) method).
+        */
+        template< class OutputBdN >
+        void outputNotSatisfied( OutputBdN * bdN )
+        {
+            for( deque<IND>::iterator it = listNotSatisfied.begin() ; it != listNotSatisfied.end() ; ++it )
+                 bdN->push_back( *it, Boolean( true ) ) ;
+        }
+};
+
+//! Execute the initialization of the basic word of the language (the di of size 1) in the algorithm
+template< class Data, class InputDBFormat, class Predicate >
+void InitIND_Index<Data,InputDBFormat,Predicate>::operator() ( )
+{
+    if( listElements.size() || listNotSatisfied.size() ) // already initialized
+        return ;
+
+    int nbAttrib1 = input1->attributes.size() ;
+    int nbAttrib2 = input2->attributes.size() ;
+    int nbWords = ( nbAttrib2 + 63 ) / 64 ; // a set of attributes of the second relation is stored in nbWords words of 64 bits
+
+    // for each value of the second relation, the set of the attributes containing this value
+    unordered_map< int, vector< unsigned long long > > attribsOfValue ;
+
+    for( typename Data::iterator it = table2->begin() ; it != table2->end() ; ++it )
+    {
+         for( int a = 0 ; a < nbAttrib2 ; a++ )
+         {
+              vector< unsigned long long > & attribs = attribsOfValue[ (*it)[ a ] ] ;
+              if( attribs.empty() )
+                  attribs.resize( nbWords, 0 ) ;
+              attribs[ a / 64 ] |= 1ULL << ( a % 64 ) ;
+         }
+    }
+
+    // for each attribute of the first relation, the set of the attributes of the second relation containing all its values
+    vector< vector< unsigned long long > > included( nbAttrib1, vector< unsigned long long >( nbWords, ~0ULL ) ) ;
+
+    for( typename Data::iterator it = table1->begin() ; it != table1->end() ; ++it )
+    {
+         for( int a = 0 ; a < nbAttrib1 ; a++ )
+         {
+              typename unordered_map< int, vector< unsigned long long > >::iterator itValue = attribsOfValue.find( (*it)[ a ] ) ;
+
+              if( itValue == attribsOfValue.end() ) // the value is not in the second relation
+                  included[ a ].assign( nbWords, 0 ) ;
+              else
+                  for( int w = 0 ; w < nbWords ; w++ )
+                       included[ a ][ w ] &= itValue->second[ w ] ;
+         }
+    }
+
+    // the unary INDs in the same order than InitIND
+    for( int i = 0; i< nbAttrib1; ++i)
+    {
+         string left =input1->attributes[i] ;
+         for( int j = 0; j< nbAttrib2; ++j)
+         {
+              IND elemdi;
+              elemdi.left.push_back( left );
+              elemdi.right.push_back(  input2->attributes[j] );
+
+              if( included[ i ][ j / 64 ] & ( 1ULL << ( j % 64 ) ) )
+              {
+                  listElements.push_back( elemdi );
+                  pred->unarySatisfied.insert( make_pair( left, input2->attributes[j] ) );
+              }
+              else
+                  listNotSatisfied.push_back( elemdi );
+         }
+    }
+}
+
+
+#endif
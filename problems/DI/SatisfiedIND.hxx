@@ -23,6 +23,11 @@
 
 #include<set>
 #include<utility>
+#include<map>
+#include<deque>
+#include<memory>
+#include<mutex>
+#include<unordered_set>
 
 #include "Predicate.hxx"
 #include "PTree.hxx"
@@ -32,10 +37,17 @@
 /*!
     This functor test if a IND is satisfied.  
     The method used to test if a candidate is a a satisfied IND is the following one:        
-        * process the projection wrt the attributes of the left side of the candidate IND.
-        * process the projection wrt the attributes of the right side of the candidate IND.
-        * check that each element of left side projection is included in the right side projection.
-        * return true if all the element are included.    
+        * process the projection wrt the attributes of the right side of the candidate IND (in a hash table).
+        * project each tuple of the first relation wrt the attributes of the left side of the candidate IND.
+        * return false as soon as a projected tuple is not in the right side projection.
+        * return true if all the projected tuples are included.    
+    
+    The projections of the second relation are stored in a cache (by sequence of attributes),
+    since the same right side is used by a lot of candidates.
+    When the cache is full, the oldest projections are removed.
+    The cache is protected by a lock, so the candidates can be tested by several threads (see Apriori::nbPredicateThreads).
+    
+    The unary INDs already known to be satisfied (see InitIND_Index) are stored in unarySatisfied and are not tested again.
     
     The template parameter Data is the type of the tablular data.
 */
@@ -47,46 +59,70 @@ class SatisfiedIND: public Predicate
     protected:
                     
       
+        //! Hash function of a projected tuple
+        struct hashTuple
+        {
+            size_t operator() ( const vector<int> & tuple ) const
+            {
+                size_t h = tuple.size() ;
+                for( vector<int>::const_iterator it = tuple.begin() ; it != tuple.end() ; ++it )
+                     h ^= *it + 0x9e3779b9 + ( h << 6 ) + ( h >> 2 ) ;
+                return h ;
+            }
+        };
+        
+        //! Projection of a relation (set of projected tuples)
+        typedef unordered_set< vector<int>, hashTuple > Projection ;
+        
+        //! function used to get the number of the attributes of a set of attributes.
+        /*!
+            \param setOfAttrib set of attributes.
+            \param numAttrib return the number of the attribute in the relation (not modified).
+            \param setOfAttribNum stores the number of the attributes.
+            \return false if an attribute is not in the relation.
+        */          
+        template< class ContainerAttrib >                  
+        bool numbers( ContainerAttrib & setOfAttrib, RecodeToInt< string > & numAttrib, vector<int> & setOfAttribNum ) ;
+              
         //! function used to project a relation  wrt a set of attributes.
         /*!
             \param relation class representing the relation.
-            \param ContainerAttrib set of attribute used for the projection.
+            \param setOfAttribNum number of the attributes used for the projection.
             \param ContainerProject container used to store the projection.
         */          
-        template< class ContainerAttrib, class ContainerProject  >                  
-        void projection( Data * relation, ContainerAttrib & setOfAttrib, ContainerProject & project,  RecodeToInt< string > & numAttrib  ) ;
+        template< class ContainerProject  >                  
+        void projection( Data * relation, vector<int> & setOfAttribNum, ContainerProject & project ) ;
               
+        //! Return the projection of the second relation wrt a sequence of attributes (from the cache, or computed and inserted in the cache)
+        /*!
+            \param setOfAttribNum number of the attributes used for the projection.
+        */          
+        shared_ptr< const Projection > projection2( vector<int> & setOfAttribNum ) ;
               
         //! Functor used to projet all the tuples wrt attributes studied 
-        template< class ContainerAttrib, class ContainerProject >
+        template< class ContainerProject >
         class ProcessTuples
         {            
-                 //! set of attribute used for the projection
-                 ContainerAttrib * setOfAttrib;      
+                 //! number of the attributes used for the projection
+                 vector<int> * setOfAttribNum;      
                  
                  //! container used to store the projection
                  ContainerProject * project;
                  
-                 //! return the number of the attributes of the relation
-                 RecodeToInt< string > * numAttrib ;
-                 
                  //! the projected tuple with the value of the attributes recoded
                  vector<int> tupleProjected;
 
             
             public:
-                 ProcessTuples( ContainerAttrib & insetOfAttrib, ContainerProject & inproject,  RecodeToInt< string > & innumAttrib  )
+                 ProcessTuples( vector<int> & insetOfAttribNum, ContainerProject & inproject )
                  { 
-                         setOfAttrib = & insetOfAttrib;
+                         setOfAttribNum = & insetOfAttribNum;
                          project = & inproject ;
-                         numAttrib = & innumAttrib ;
                  }
                  
                  template< class ContainerTuple >
                  void operator() ( ContainerTuple &  tuple)
                  {
-                      vector<int> * setOfAttribNum = & (*numAttrib)(*setOfAttrib);
-
                       tupleProjected.resize( 0 );
                       tupleProjected.reserve( setOfAttribNum->size() );                      
 
@@ -136,8 +172,25 @@ class SatisfiedIND: public Predicate
         //! Used to get the numero of the attributes ( 1st, 2nd,...) of the first relation.
         RecodeToInt< string > numAttrib2 ; 
 
+        //! Projections of the second relation already computed (by sequence of attributes)
+        map< vector<int>, shared_ptr< const Projection > > cache ;
+        
+        //! Sequences of attributes of the cache, in the order they have been inserted
+        deque< vector<int> > cacheOrder ;
+        
+        //! Number of values stored in the cache
+        long cacheSize ;
+        
+        //! Lock used to access the cache
+        mutex lock ;
             
     public:  
+        
+        //! Maximum number of values (of the projected tuples) stored in the cache (by default 64M)
+        long maxCacheSize ;
+        
+        //! Unary INDs already known to be satisfied (left and right attributes), they are not tested again (filled by InitIND_Index)
+        set< pair< string, string > > unarySatisfied ;
                     
         //! Constructor
         /*!
@@ -155,6 +208,8 @@ class SatisfiedIND: public Predicate
                   table2 = & intable2 ; 
                   numAttrib2(input2.attributes) ;
                   
+                  cacheSize = 0 ;
+                  maxCacheSize = 1L << 26 ;
         }
  
         //! Destructor
@@ -168,21 +223,83 @@ class SatisfiedIND: public Predicate
 
 
       
+//! function used to get the number of the attributes of a set of attributes.
+/*!
+    \param setOfAttrib set of attributes.
+    \param numAttrib return the number of the attribute in the relation (not modified).
+    \param setOfAttribNum stores the number of the attributes.
+    \return false if an attribute is not in the relation.
+*/          
+template< class Data > template< class ContainerAttrib >                  
+bool SatisfiedIND<Data >::numbers( ContainerAttrib & setOfAttrib, RecodeToInt< string > & numAttrib, vector<int> & setOfAttribNum ) 
+{
+     // numAttrib is not modified, so that several candidates can be tested at the same time
+     map< string, int > * ids = numAttrib.getIdTointernid() ;
+     setOfAttribNum.reserve( setOfAttrib.size() ) ;
+     for( typename ContainerAttrib::iterator it = setOfAttrib.begin() ; it != setOfAttrib.end() ; ++it )
+     {
+          map< string, int >::iterator itId = ids->find( *it ) ;
+          if( itId == ids->end() )
+              return false ;
+          setOfAttribNum.push_back( itId->second ) ;
+     }
+     return true ;
+}
+
 //! function used to project a relation  wrt a set of attributes.
 /*!
     \param relation class representing the relation.
-    \param setOfAttrib set of attribute used for the projection.
+    \param setOfAttribNum number of the attributes used for the projection.
     \param project container used to store the projection.
-    \param recodedval used to recode the attributes the value in int
-    \param numAttrib return the number of the attribute in the relation
 */          
-template< class Data > template< class ContainerAttrib, class ContainerProject  >                  
-void SatisfiedIND<Data >::projection( Data * relation, ContainerAttrib & setOfAttrib, ContainerProject & project, RecodeToInt< string > & numAttrib  ) 
+template< class Data > template< class ContainerProject  >                  
+void SatisfiedIND<Data >::projection( Data * relation, vector<int> & setOfAttribNum, ContainerProject & project ) 
 {
-     for_each( relation->begin(), relation->end(), ProcessTuples<ContainerAttrib,ContainerProject>( setOfAttrib, project, numAttrib ) );
+     for_each( relation->begin(), relation->end(), ProcessTuples<ContainerProject>( setOfAttribNum, project ) );
 
 }
 
+//! Return the projection of the second relation wrt a sequence of attributes (from the cache, or computed and inserted in the cache)
+/*!
+    \param setOfAttribNum number of the attributes used for the projection.
+*/          
+template< class Data >
+shared_ptr< const typename SatisfiedIND<Data>::Projection > SatisfiedIND<Data >::projection2( vector<int> & setOfAttribNum ) 
+{
+     typename map< vector<int>, shared_ptr< const Projection > >::iterator it ;
+     
+     {
+         lock_guard< mutex > guard( lock ) ;
+         
+         it = cache.find( setOfAttribNum ) ;
+         if( it != cache.end() )
+             return it->second ;
+     }
+     
+     // the projection is computed without the lock (several projections can be computed at the same time)
+     shared_ptr< Projection > proj( new Projection ) ;
+     projection( table2, setOfAttribNum, *proj ) ;
+     
+     lock_guard< mutex > guard( lock ) ;
+     
+     if( ! cache.insert( make_pair( setOfAttribNum, proj ) ).second ) // already computed by another thread
+         return proj ;
+     
+     cacheOrder.push_back( setOfAttribNum ) ;
+     cacheSize += proj->size() * setOfAttribNum.size() ;
+     
+     // remove the oldest projections if the cache is full
+     while( cacheSize > maxCacheSize && cacheOrder.size() > 1 )
+     {
+          it = cache.find( cacheOrder.front() ) ;
+          cacheSize -= it->second->size() * it->first.size() ;
+          cache.erase( it ) ;
+          cacheOrder.pop_front() ;
+     }
+     
+     return proj ;
+}
+
 
 
 //! Operator that test if a set of attributes is a super key
@@ -193,19 +310,31 @@ void SatisfiedIND<Data >::projection( Data * relation, ContainerAttrib & setOfAt
 template< class Data > template< class Iterator, class Measure>
 bool SatisfiedIND<Data >::operator() ( Iterator    itCand, Measure & mesCand )
 { 
-    set< vector<int> >  proj1 ; // projection of each tuple of table1
-    set< vector<int> >  proj2 ;
-         
-    // project the relation 1 wrt the attributes in the candidate tested
-    projection( table1, itCand->left, proj1, numAttrib1 );   
+    if( itCand->left.size() == 1 && unarySatisfied.count( make_pair( itCand->left.front(), itCand->right.front() ) ) ) // already tested
+        return true ;
     
-     // project the relation 1  wrt the attributes in the candidate tested
-    projection( table2,   itCand->right, proj2, numAttrib2 ); 
-     
-    if( includes( proj2.begin(), proj2.end(),proj1.begin(),proj1.end() ) ) // test if the di is satisfied
-        return true;
+    vector<int> left ;  // number of the attributes of the left side in table1
+    vector<int> right ; // number of the attributes of the right side in table2
+    if( ! numbers( itCand->left, numAttrib1, left ) || ! numbers( itCand->right, numAttrib2, right ) ) // unknown attribute
+        return false ;
+    
+    // project the relation 2 wrt the attributes in the candidate tested
+    shared_ptr< const Projection > proj2 = projection2( right ) ; 
+    
+    // project each tuple of the relation 1 wrt the attributes in the candidate tested
+    vector<int> tupleProjected ;
+    tupleProjected.reserve( left.size() ) ;
+    
+    for( typename Data::iterator it = table1->begin() ; it != table1->end() ; ++it )
+    {
+         tupleProjected.resize( 0 ) ;
+         for_each( left.begin(), left.end(), project2< typename Data::value_type >( *it, tupleProjected ) ) ;
+         
+         if( proj2->find( tupleProjected ) == proj2->end() ) // the di is not satisfied
+             return false ;
+    }
         
-    return false;                                                                                        
+    return true;                                                                                        
 }
 
         
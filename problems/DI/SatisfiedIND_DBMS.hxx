@@ -22,17 +22,31 @@
 #define SATISFIEDIND_DBMS_HXX
 
 #include<set>
+#include<map>
+#include<vector>
+#include<string>
 #include<utility>
 
 #include "Predicate.hxx"
+#include "IND.hpp"
+#include "SatisfiedIND.hxx"
+#include "RecodeToInt.hxx"
 
 //! Functor representing the predicate being a satisfied IND wrt to 2 relations in a SGBD. 
 /*!
     This functor test if a IND is satisfied for two relation stored in a DBMS.
     Note that each time the functor is used, a query is executed on the database.   
     
+    To reduce the number of queries, two other modes can be used:
+        * batch (batchSize > 1): before the test of the candidates (preProcessing), the candidates not already tested
+          are tested by queries testing batchSize candidates at once, and the results are stored.
+        * bulk (readRelations()): the two relations are read once from the DBMS (one query by relation),
+          and the candidates are tested in memory with SatisfiedIND (the NULL values are read as empty strings).
+    
     The template parameter DBMS is the class representing the connection to the DBMS.
     This class is used to do operations on the DBMS such as connect, execute a query ...
+    The function exec_query( rows ), reading all the rows of a query, is only needed in bulk mode.
+    See Mysql_db (Mysql.hpp) or Csv_db (CsvDB.hpp).
     
     The attributes in the two relations must have the same data type.
 */
@@ -44,8 +58,54 @@ class SatisfiedIND_DBMS: public Predicate
         //! Pointer on the dbms
         DBMS * mydbms;
 
-            
+        //! Parameterized query used to test a candidate
+        string query ;
+        
+        //! Results of the candidates tested by the batch queries (removed once used by the predicate)
+        map< string, bool > results ;
+        
+        //! Used to recode the values of the relations read in bulk mode (shared by the two relations)
+        RecodeToInt< string > recodeValues ;
+        
+        //! The first relation (in bulk mode)
+        vector< vector<int> > table1 ;
+        
+        //! The second relation (in bulk mode)
+        vector< vector<int> > table2 ;
+        
+        //! Predicate used to test the candidates in memory (in bulk mode, 0 otherwise)
+        SatisfiedIND< vector< vector<int> > > * inMemory ;
+        
+        //! Return the attributes of a side of a IND separated by ","
+        static string attributes( vector<string> & side )
+        {
+             string attrib = side[0] ;
+             for( int i = 1; i < side.size(); i++)
+                  attrib+=","+side[i] ;
+             return attrib ;
+        }
+        
+        //! Read all the tuples of a relation of the DBMS
+        /*!
+            \param rel the relation
+            \param table stores the tuples, with the values recoded in int
+            \return false if the relation cannot be read
+        */
+        template< class Relation >
+        bool load( Relation * rel, vector< vector<int> > & table ) ;
+        
+        //! Test a set of candidates with one query
+        /*!
+            \param keys the candidates ( left side, " [ ", and right side ) 
+            \param lefts the left side of the candidates
+            \param rights the right side of the candidates
+        */
+        void testBatch( vector<string> & keys, vector<string> & lefts, vector<string> & rights ) ;
+        
     public:  
+        
+        //! Number of candidates tested by each query in preProcessing (1 by default, ie one query by candidate when it is tested)
+        int batchSize ;
                     
         //! Constructor
         /*!
@@ -54,34 +114,60 @@ class SatisfiedIND_DBMS: public Predicate
         SatisfiedIND_DBMS( DBMS * inDbms )
         { 
                 mydbms = inDbms ;  
+                batchSize = 1 ;
+                inMemory = 0 ;
                 
                 if( mydbms->get_relation(1) && mydbms->get_relation(2) )
                 {                                     
                     // store a parameretrized query on the two relations to test the dependencies
-                    string query = "select count(*) from "+  mydbms->get_relation(1)->name + " where ( var1 ) not in( SELECT distinct var2 FROM "+  mydbms->get_relation(2)->name +" )" ;                
+                    query = "select count(*) from "+  mydbms->get_relation(1)->name + " where ( var1 ) not in( SELECT distinct var2 FROM "+  mydbms->get_relation(2)->name +" )" ;                
                     mydbms->store_query( (char *)(query.c_str()) );
                 }
                 
         }
  
         //! Destructor
-        ~SatisfiedIND_DBMS(){}            
+        ~SatisfiedIND_DBMS(){ if( inMemory ) delete inMemory ; }            
+        
+        //! Use the bulk mode: the two relations are read once and the candidates are tested in memory
+        /*!
+            \return false if the relations cannot be read (the candidates are then tested by queries)
+        */
+        bool readRelations() ;
+        
+        //! Function used to test the candidates by batch before they are tested (if batchSize > 1).
+        /*!
+            All the candidates not already tested by a batch query are tested.
+            \param cand container of words of the language.
+            \param wordToSet functor transforming the sets in IND
+        */
+        template< class Cand_DataStruct, class f >
+        void preProcessing( Cand_DataStruct & cand, f  wordToSet ) ;
         
         //! Operator that test if a set of attributes is not redundant
         template< class Iterator, class Measure >
         bool operator() ( Iterator  itCand, Measure & mesCand )
         {       
+             if( inMemory )
+                 return (*inMemory)( itCand, mesCand ) ;
 
              //search the attributes in the left part of the IND
-             string left= itCand->left[0] ;
-             for( int i = 1; i < itCand->left.size(); i++)
-                  left+=","+itCand->left[i] ;
-
+             string left= attributes( itCand->left ) ;
                                                 
              //search the attributes in the right part of the IND
-             string right= itCand->right[0] ;
-             for( int i = 1; i < itCand->right.size(); i++)
-                  right+=","+itCand->right[i] ;                  
+             string right= attributes( itCand->right ) ;
+
+             // the candidate has been tested by a batch query
+             if( results.size() )
+             {
+                 map< string, bool >::iterator itRes = results.find( left + " [ " + right ) ;
+                 if( itRes != results.end() )
+                 {
+                     bool satisfied = itRes->second ;
+                     results.erase( itRes ) ; // each candidate is tested once
+                     return satisfied ;
+                 }
+             }
 
              left= " "+left+" ";
              right=" "+right+" ";
@@ -106,5 +192,126 @@ class SatisfiedIND_DBMS: public Predicate
                  
 };   
 
+//! Read all the tuples of a relation of the DBMS
+/*!
+    \param rel the relation
+    \param table stores the tuples, with the values recoded in int
+    \return false if the relation cannot be read
+*/
+template< class DBMS > template< class Relation >
+bool SatisfiedIND_DBMS<DBMS>::load( Relation * rel, vector< vector<int> > & table )
+{
+     string select = "select " + attributes( rel->attributes ) + " from " + rel->name ;
+     mydbms->store_query( (char *)(select.c_str()) );
+
+     vector< vector<string> > rows ;
+     if( ! mydbms->exec_query( rows ) )
+         return false ;
+
+     table.reserve( rows.size() ) ;
+     for( int t = 0 ; t < rows.size() ; t++ )
+     {
+          table.push_back( vector<int>() ) ;
+          table.back().reserve( rows[ t ].size() ) ;
+          for( int a = 0 ; a < rows[ t ].size() ; a++ )
+               table.back().push_back( recodeValues( rows[ t ][ a ] ) ) ;
+          vector<string>().swap( rows[ t ] ) ;
+     }
+
+     return true ;
+}
+
+//! Use the bulk mode: the two relations are read once and the candidates are tested in memory
+/*!
+    \return false if the relations cannot be read (the candidates are then tested by queries)
+*/
+template< class DBMS >
+bool SatisfiedIND_DBMS<DBMS>::readRelations()
+{
+     if( inMemory )
+         return true ;
+     
+     if( ! mydbms->get_relation(1) || ! mydbms->get_relation(2) )
+         return false ;
+     
+     bool loaded = load( mydbms->get_relation(1), table1 ) && load( mydbms->get_relation(2), table2 ) ;
+     
+     if( loaded )
+         inMemory = new SatisfiedIND< vector< vector<int> > >( table1, *mydbms->get_relation(1), table2, *mydbms->get_relation(2) ) ;
+     else
+     {
+         vector< vector<int> >().swap( table1 ) ;
+         vector< vector<int> >().swap( table2 ) ;
+     }
+     
+     // restore the parameterized query
+     mydbms->store_query( (char *)(query.c_str()) );
+     
+     return loaded ;
+}
+
+//! Test a set of candidates with one query
+/*!
+    \param keys the candidates ( left side, " [ ", and right side ) 
+    \param lefts the left side of the candidates
+    \param rights the right side of the candidates
+*/
+template< class DBMS >
+void SatisfiedIND_DBMS<DBMS>::testBatch( vector<string> & keys, vector<string> & lefts, vector<string> & rights )
+{
+     // the query returns a character for each candidate: 1 if there are values not in the second relation, 0 otherwise
+     string batch = "select concat( " ;
+     for( int i = 0 ; i < keys.size() ; i++ )
+     {
+          if( i ) batch += ", " ;
+          batch += "exists( select * from " + mydbms->get_relation(1)->name + " where ( " + lefts[ i ] + " ) not in( SELECT distinct " + rights[ i ] + " FROM " + mydbms->get_relation(2)->name + " ) )" ;
+     }
+     batch += " )" ;
+
+     mydbms->store_query( (char *)(batch.c_str()) );
+     string res = mydbms->exec_query();
+
+     for( int i = 0 ; i < keys.size() && i < res.size() ; i++ )
+          results[ keys[ i ] ] = ( res[ i ] == '0' ) ;
+
+     keys.resize( 0 ) ; lefts.resize( 0 ) ; rights.resize( 0 ) ;
+}
+
+//! Function used to test the candidates by batch before they are tested (if batchSize > 1).
+/*!
+    All the candidates not already tested by a batch query are tested.
+    \param cand container of words of the language.
+    \param wordToSet functor transforming the sets in IND
+*/
+template< class DBMS > template< class Cand_DataStruct, class f >
+void SatisfiedIND_DBMS<DBMS>::preProcessing( Cand_DataStruct & cand, f  wordToSet )
+{
+     if( inMemory || batchSize < 2 || ! mydbms->get_relation(1) || ! mydbms->get_relation(2) )
+         return ;
+
+     vector<string> keys, lefts, rights ;
+
+     for( typename Cand_DataStruct::iterator it = cand.beginLeaf() ; it != cand.end() ; it = it.nextLeaf() )
+     {
+          IND * ind = wordToSet.inverse( it ) ;
+          string left = attributes( ind->left ) ;
+          string right = attributes( ind->right ) ;
+          string key = left + " [ " + right ;
+
+          if( results.find( key ) == results.end() ) // not already tested
+          {
+              keys.push_back( key ) ; lefts.push_back( left ) ; rights.push_back( right ) ;
+              if( keys.size() == batchSize )
+                  testBatch( keys, lefts, rights ) ;
+          }
+     }
+
+     if( keys.size() )
+         testBatch( keys, lefts, rights ) ;
+
+     // restore the parameterized query
+     mydbms->store_query( (char *)(query.c_str()) );
+}
+
         
 #endif 
@@ -25,17 +25,19 @@
 
 #include "Frequent.hxx"
 #include "SupportDisj.hpp"
-#include "TestSubsets.hxx"
 
 
 //! Functor representing the predicate being frequent essential. 
 /**
     This functor test if an itemset is frequent and essential.
     This functor process the support and the disjunction before pruning.  
+    The disjunctions of all the frequent candidates are processed in bulk after the support counting (preProcessing),
+    with the bitmaps of the transactions containing each item: the disjunction of an itemset is the number of bits set in the union (or) of the bitmaps of its items.
+    The bitmaps are built once from the db reconstructed with the frequent items (one bit per transaction).
     We suppose that the data has the same internal encoding  than the candidates (ie, the first item met is recoded in "0", the second in "1", ...).
     
     The methods of this predicate are specific to tries data structure (PTree for the candiates and Tatree for the transactions).
-    For the moment, this functor can only be used when using a levelwise exploration of the search space (Apriori) since it checks for subsets already generated.
+    The disjunctions of the k-1 subsets are also processed with the bitmaps, so that the subsets do not have to be in the trie (for example with Abs).
        
     The template parameter Data is the type of the transactional database.
     The template parameter SetsType is the type of the items.    
@@ -61,33 +63,40 @@ class Essential: public Frequent< Data, SetsType>
         
        
         typedef typename vector< int >::iterator ItVectInt;
+        
+        typedef VerticalDB<int>::Bitmap Bitmap;
+        
+        //! Bitmap of the transactions containing each item (wrt the internal id of the items)
+        vector< Bitmap > itemBitmaps ;
              
-                
-        //! Method used to count the disjunction of a set of itemsets
+        //! Method used to build the bitmaps of the items from the db (stored in a trie or in a vertical db)
         /**
-            \param itbegin iterator on the first element of the itemset 
-            \param itend iterator on the last element of the itemset 
-            \parm itTat iterator on the root node on the tatree storing the database
-            \return the number of transactions intersecting the itemset 
+            \param data the db
         */
-        template< class Iterator >
-        int countDisj( ItVectInt itbegin, ItVectInt itend, Iterator itTat  ) ;
-        
-       //! Functor used int the TestSubsets functor to test if an itesmet is essential 
-       /**
-           Test if two itemsets have the same disjunction values.
-       */
-       class equalDisj
-       {
-        public:
-               
-               template< class Iterator >
-               bool operator()( Iterator it1 , Iterator it2 )
-               {
-                    return it1.measure().disj == it2.measure().disj ;
-               }              
-            
-       };
+        template< class DataStructDB >
+        void buildBitmaps( DataStructDB & data ) ;
+        
+        //! Method used to count the disjunction of the frequent itemsets not already tested (ie the candidates)
+        /**
+            The candidates can have several lengths (for example the sets of the dualization with Abs), so all the nodes of the trie are explored.
+            \param currNode curent node of the trie storing the itemsets
+            \param prefix bitmap of the transactions intersecting the prefix of the itemsets of the node (0 for the root)
+        */
+        template< class Measure >
+        void countDisj( Node<int, Measure> * currNode, Bitmap * prefix ) ;
+        
+        //! Bitmaps of the transactions containing at least one item (once) and at least two items (twice) of the itemset tested
+        Bitmap once, twice ;
+        
+        //! Method used to test if each item of an itemset is in a transaction without the other items, ie if the disjunctions of its k-1 subsets are lower than its disjunction
+        /**
+            The subsets are not searched in the trie, so they do not have to be in it (for example with Abs).
+            \param itbegin iterator on the first item of the itemset
+            \param itend iterator on the end of the itemset
+            \param disj the disjunction of the itemset (it is processed if it is 0)
+        */
+        bool isEssential( ItVectInt itbegin, ItVectInt itend, int & disj ) ;
+        
         
     public: 
                                 
@@ -114,7 +123,7 @@ class Essential: public Frequent< Data, SetsType>
              if( itemsetIt->size() == 1 ) // use the items process in the initialization phase
              {
 
-                 ItListItemSupp it  = find_if( this->listItemSupport.begin(), this->listItemSupport.end(),  eqItemSupp( * (itemsetIt->begin()) ) );
+                 typename Frequent< Data, SetsType>::ItMapItemSupp it  = this->itemSupport.find( * (itemsetIt->begin()) );
                             
                  mesCand.supp = it->second ;  
 
@@ -140,63 +149,170 @@ class Essential: public Frequent< Data, SetsType>
 
              if(  mesCand >= this->minsup )
              {
-                  mesCand.disj = countDisj( itemsetIt->begin(), itemsetIt->end(),  this->db->data().beginRoot() );
-                  
-                  TestSubsets<SetsType> isNotEssential;
-
-                  return ! isNotEssential( itemsetIt, equalDisj() );                  
+                  if( itemBitmaps.empty() )
+                      buildBitmaps( this->db->data() ) ;
+                      
+                  // the disjunction is processed if it has not been processed with the other candidates (preProcessing)
+                  return isEssential( itemsetIt->begin(), itemsetIt->end(), mesCand.disj ) ;
              }
               
              return false ;               
         }    
         
+        //! Function used to count the support and the disjunction of the itemsets 
+        /**
+            The support of the itemsets is counted (see Frequent), 
+            and then the disjunction of the frequent itemsets is processed with the bitmaps of the items.
+            \param cand container of words of the language.
+            \param wordToset functor that eventually transforms itemsets
+        */
+        template< class Cand_DataStruct, class f >
+        void preProcessing( Cand_DataStruct & cand , f  wordToSet );
+        
 };   
 
+//! Function used to count the support and the disjunction of the itemsets 
+/**
+    \param cand container of words of the language.
+    \param wordToset functor that eventually transforms itemsets
+*/
+template< class Data, class SetsType  > template< class Cand_DataStruct, class f >
+void Essential<Data,SetsType>::preProcessing( Cand_DataStruct & cand , f  wordToSet )
+{
+    Frequent< Data, SetsType>::preProcessing( cand, wordToSet ) ;
+    
+	if(  cand.getHead() &&  cand.length() > 1 )  // the disjunction of the items is their support
+	{
+        clock_t start = clock();
+        
+        if( itemBitmaps.empty() ) // the db has been reconstructed with the frequent items
+            buildBitmaps( this->db->data() ) ;
+            
+        countDisj( cand.getHead(), 0 ) ;
+       	
+       	if( this->verbose ) cout<<" Disj ["<<(clock()-start)/CLOCKS_PER_SEC<<"s] ";
+    }
+}
 
+//! Method used to build the bitmaps of the items from the db (stored in a trie or in a vertical db)
+/**
+    \param data the db
+*/    
+template< class Data, class SetsType > template< class DataStructDB > 
+void Essential<Data,SetsType>::buildBitmaps( DataStructDB & data )
+{
+    VerticalDB<int> bitmaps ;
+    
+    bitmaps.build( data ) ;
+    
+    itemBitmaps.resize( bitmaps.nbElements() ) ;
+    for( int i = 0 ; i < bitmaps.nbElements() ; i++ )
+         itemBitmaps[ i ].swap( bitmaps.bitmap( i ) ) ;
+}
 
-//! Method used to count and save the support of a set of itemsets
+//! Method used to count the disjunction of the frequent itemsets not already tested (ie the candidates)
 /**
     \param currNode curent node of the trie storing the itemsets
-    \param itData iterator on the data
+    \param prefix bitmap of the transactions intersecting the prefix of the itemsets of the node (0 for the root)
 */    
-template< class Data, class SetsType > template< class Iterator > 
-int Essential<Data,SetsType>::countDisj( ItVectInt itbegin, ItVectInt itend, Iterator itTat )
+template< class Data, class SetsType > template< class Measure > 
+void Essential<Data,SetsType>::countDisj( Node<int, Measure> * currNode, Bitmap * prefix )
 {
-    int disj = 0 ;
-
-    itTat.beginChildNode() ;
-    Iterator end ; //end iterator
+    typedef Node<int,Measure> Node;
     
-    vector< int >::iterator it = itbegin ;
-    vector< int >::iterator last = itend ;
-    --last;
+    if( currNode == 0 || currNode->getCnts() == 0 ) return ;
     
-    int id; // internal id of the current element 
-            // we use the internal id to easily know the order of the elements
-
-    while( itTat != end && it != itend && itTat.elementId() <=  ( this->recode( *last) ) )
+    typename Node::vectN * childs = currNode->getChilds(); 
+    int n = currNode->getOffset() ;
+    int size = currNode->getCnts()->size() ;
+    Node * next ;
+    
+    Bitmap empty ;
+    
+    // bitmap of the prefix of the itemsets of the child nodes
+    Bitmap uni ;
+    
+    for( int i = 0 ; i < size ; i++ )
     {
-           id = this->recode( *it) ; 
+        Bitmap & item = n + i < (int) itemBitmaps.size() ? itemBitmaps[ n + i ] : empty ;
+        
+        // the disjunction of the items is their support (see operator())
+        if( prefix && currNode->existVal( i ) && currNode->getMeasure(i).presence && currNode->getMeasure(i) >= this->minsup )
+            currNode->getMeasure(i).disj = VerticalDB<int>::unite( *prefix, item ) ;
+        
+        next = ( childs && i < childs->size() ) ? (*childs)[i] : 0 ;
+        
+        if( next )
+        {
+            if( prefix )
+            {
+                VerticalDB<int>::unite( *prefix, item, &uni ) ;
+                countDisj( next, &uni ) ;
+            }
+            else
+                countDisj( next, &item ) ;
+        }
+    }
+}
 
-           if( itTat.elementId() == id )
-           {
-               disj += itTat.measure();
-               ++it ;
-              
-               itTat.nextChild() ;    
-           }
-           else if( itTat.elementId() > id )
-           {
-               ++it;                     
-           }
-           else
-           {         
-               disj += countDisj( it, itend, itTat ) ;
-               itTat.nextChild() ;
-               
-           }                      
-    }       
-    return disj;
+
+
+//! Method used to test if each item of an itemset is in a transaction without the other items, ie if the disjunctions of its k-1 subsets are lower than its disjunction
+/**
+    \param itbegin iterator on the first item of the itemset
+    \param itend iterator on the end of the itemset
+    \param disj the disjunction of the itemset (it is processed if it is 0)
+*/    
+template< class Data, class SetsType >
+bool Essential<Data,SetsType>::isEssential( ItVectInt itbegin, ItVectInt itend, int & disj )
+{
+    typedef VerticalDB<int>::Word Word ;
+    
+    int size = 0 ; // number of words of the bitmaps
+    int id ; // internal id of the current item
+    ItVectInt it ;
+    
+    for( it = itbegin ; it != itend ; ++it )
+         if( ( id = this->recode( *it ) ) >= 0 && id < (int) itemBitmaps.size() && (int) itemBitmaps[ id ].size() > size )
+             size = itemBitmaps[ id ].size() ;
+    
+    once.assign( size, 0 ) ;
+    twice.assign( size, 0 ) ;
+    
+    for( it = itbegin ; it != itend ; ++it )
+    {
+        if( ( id = this->recode( *it ) ) < 0 || id >= (int) itemBitmaps.size() )
+            continue ;
+        
+        Bitmap & item = itemBitmaps[ id ] ;
+        for( int w = 0 ; w < (int) item.size() ; w++ )
+        {
+             twice[ w ] |= once[ w ] & item[ w ] ;
+             once[ w ] |= item[ w ] ;
+        }
+    }
+    
+    if( disj == 0 )
+        for( int w = 0 ; w < size ; w++ )
+             disj += VerticalDB<int>::popcount( once[ w ] ) ;
+    
+    // the disjunction of the subset without an item is lower if the item is in a transaction without the other items
+    for( it = itbegin ; it != itend ; ++it )
+    {
+        Word alone = 0 ;
+        
+        if( ( id = this->recode( *it ) ) >= 0 && id < (int) itemBitmaps.size() )
+        {
+            Bitmap & item = itemBitmaps[ id ] ;
+            for( int w = 0 ; w < (int) item.size() && ! alone ; w++ )
+                 alone = item[ w ] & ~twice[ w ] ;
+        }
+        
+        if( ! alone )
+            return false ;
+    }
+    
+    return true ;
 }
 
 
@@ -21,11 +21,18 @@
 #ifndef FREQUENT_HXX
 #define FREQUENT_HXX
 
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+
 #include "Predicate.hxx"
 #include "RecodeToInt.hxx"
 
 #include "Node.hxx"
+#include "FlatPTree.hxx"
+#include "FrozenTatree.hxx"
 #include "Support.hpp"
+#include "VerticalDB.hxx"
 
 
 //! Functor representing the predicate being frequent. 
@@ -49,6 +56,8 @@ class Frequent: public Predicate
         typedef  list<ItemSupp > listItemSupp ;
         typedef typename   listItemSupp::iterator ItListItemSupp ;
         typedef typename   listItemSupp::reverse_iterator revItListItemSupp ;
+        typedef  unordered_map<SetsType, int> mapItemSupp ;
+        typedef typename   mapItemSupp::iterator ItMapItemSupp ;
         
         //! Functor used to find an item in the list of items/support.
         class eqItemSupp 
@@ -143,24 +152,292 @@ class Frequent: public Predicate
                      //  this push_back on a binaryDB remove the trans for the tmp datastructure and insert the recoded trans in the final db
                      dbr->push_back( tmptrans ) ; 
                 }     
-        };  
-        
-                          
+        };
+
+        //! Counters used to update directly the support stored in the nodes of the candidates
+        template< class Measure >
+        class NodeCounts
+        {
+            public:
+
+                //! Return the index of the first counter of a node
+                int base( Node<int,Measure> * ){ return 0; }
+
+                //! Add the support of a transaction to the i-th element of a node
+                void add( Node<int,Measure> * currNode, int, int i, int supp )
+                {
+                     currNode->getMeasure(i)=currNode->getMeasure(i)+Measure(1,supp );
+                }
+        };
+
+        //! Private counters of a counting thread
+        /**
+            The counters of all the nodes of the candidates are stored in one vector.
+            The nodes are not modified during the counting, the counters are added to the nodes at the end.
+        */
+        template< class Measure >
+        class LocalCounts
+        {
+                //! index of the first counter of each node
+                const unordered_map< Node<int,Measure> *, int > * index ;
+
+            public:
+
+                //! the counters
+                vector<int> cnts ;
+
+                LocalCounts( const unordered_map< Node<int,Measure> *, int > * inindex, int size ){ index = inindex ; cnts.resize( size, 0 ); }
+
+                //! Return the index of the first counter of a node
+                int base( Node<int,Measure> * currNode ){ return index->find( currNode )->second ; }
+
+                //! Add the support of a transaction to the i-th element of a node
+                void add( Node<int,Measure> *, int base, int i, int supp ){ cnts[ base + i ] += supp ; }
+        };
+
+        //! Functor executed by each counting thread
+        /**
+            Each subtrie of the root of the db is a task.
+            The threads take the next task not already processed until there is no more task.
+            The last task is the count of the items stored in the root.
+        */
+        template< class Measure, class IteratorData >
+        class countThread
+        {
+                Frequent * pred ;
+
+                Node<int,Measure> * head ;
+
+                //! iterator on the root of the db
+                IteratorData root ;
+
+                //! iterators on the child nodes of the root of the db
+                vector< IteratorData > * tasks ;
+
+                //! next task to process
+                atomic<int> * next ;
+
+                LocalCounts<Measure> * local ;
+
+            public:
+
+                countThread( Frequent * inpred, Node<int,Measure> * inhead, IteratorData inroot, vector< IteratorData > * intasks, atomic<int> * innext, LocalCounts<Measure> * inlocal )
+                {
+                    pred = inpred; head = inhead ; root = inroot; tasks = intasks; next = innext ; local = inlocal ;
+                }
+
+                void operator()()
+                {
+                     int task ;
+                     while( ( task = next->fetch_add( 1 ) ) <= (int) tasks->size() )
+                     {
+                          if( task < (int) tasks->size() )
+                              pred->count( head, (*tasks)[ task ], *local );
+                          else
+                              pred->countItems( head, root, *local );
+                     }
+                }
+        };
+
+        //! Functor executed by each counting thread on the frozen db
+        /**
+            Each pair (node of the candidates, node of the db) is a task.
+            The threads take the next task not already processed until there is no more task.
+        */
+        template< class Measure >
+        class countFrozenThread
+        {
+                Frequent * pred ;
+
+                //! the tasks
+                vector< pair< Node<int,Measure> *, int > > * tasks ;
+
+                //! next task to process
+                atomic<int> * next ;
+
+                LocalCounts<Measure> * local ;
+
+            public:
+
+                countFrozenThread( Frequent * inpred, vector< pair< Node<int,Measure> *, int > > * intasks, atomic<int> * innext, LocalCounts<Measure> * inlocal )
+                {
+                    pred = inpred; tasks = intasks; next = innext ; local = inlocal ;
+                }
+
+                void operator()()
+                {
+                     int task ;
+                     vector< pair< Node<int,Measure> *, int > > stack ;
+                     while( ( task = next->fetch_add( 1 ) ) < (int) tasks->size() )
+                     {
+                          stack.push_back( (*tasks)[ task ] ) ;
+                          pred->countFrozen( stack, *local );
+                     }
+                }
+        };
 
-      
         //! Method used to count and save the support of a set of itemsets
         /**
             \param currNode curent node of the trie storing the itemsets
             \param itData iterator on the data
         */
-        template< class Measure, class IteratorData >       
+        template< class Measure, class IteratorData >
         int count( Node<int, Measure> * currNode, IteratorData  itData  ) ;
-       
+
+        //! Method used to count the support of a set of itemsets in some counters
+        /**
+            \param currNode curent node of the trie storing the itemsets
+            \param itData iterator on the data
+            \param counts counters updated (the nodes or the private counters of a thread)
+        */
+        template< class Measure, class IteratorData, class Counts >
+        void count( Node<int, Measure> * currNode, IteratorData  itData, Counts & counts ) ;
+
+        //! Method used to count the support of a set of itemsets with the items stored in the children of a node of the db
+        /**
+            \param currNode curent node of the trie storing the itemsets
+            \param itData iterator on the data
+            \param counts counters updated (the nodes or the private counters of a thread)
+        */
+        template< class Measure, class IteratorData, class Counts >
+        void countItems( Node<int, Measure> * currNode, IteratorData  itData, Counts & counts ) ;
+
+        //! Method used to count the support of a set of itemsets stored in a flat trie
+        /**
+            Same as count() with the flat layout of the trie.
+            \param tree the trie storing the itemsets
+            \param currNode index of the curent node of the trie
+            \param itData iterator on the data
+        */
+        template< class Measure, class IteratorData >
+        void countFlat( FlatPTree<int, Measure> & tree, int currNode, IteratorData  itData ) ;
+
+        //! Method used to count the support of a set of itemsets stored in a flat trie with the items stored in the children of a node of the db
+        /**
+            Same as countItems() with the flat layout of the trie.
+            \param tree the trie storing the itemsets
+            \param currNode index of the curent node of the trie
+            \param itData iterator on the data
+        */
+        template< class Measure, class IteratorData >
+        void countFlatItems( FlatPTree<int, Measure> & tree, int currNode, IteratorData  itData ) ;
+
+        //! Method used to count the support of a set of itemsets in the frozen copy of the db
+        /**
+            The two tries are explored iteratively with a stack of pairs (node of the candidates, node of the db).
+            With several threads, the pairs obtained from the root nodes are shared between the threads.
+            \param head root of the trie storing the itemsets
+        */
+        template< class Measure >
+        void countFrozen( Node<int, Measure> * head ) ;
+
+        //! Method used to count the support of the itemsets of the pairs (node of the candidates, node of the db) of a stack
+        /**
+            \param stack the pairs to process (empty at the end)
+            \param counts counters updated (the nodes or the private counters of a thread)
+        */
+        template< class Measure, class Counts >
+        void countFrozen( vector< pair< Node<int,Measure> *, int > > & stack, Counts & counts ) ;
+
+        //! Method used to process a pair (node of the candidates, node of the db)
+        /**
+            The pairs of the child nodes are pushed in the stack.
+            \param currNode the node of the candidates
+            \param index index of the node of the db
+            \param stack the pairs to process
+            \param counts counters updated (the nodes or the private counters of a thread)
+        */
+        template< class Measure, class Counts >
+        void countFrozenStep( Node<int,Measure> * currNode, int index, vector< pair< Node<int,Measure> *, int > > & stack, Counts & counts ) ;
+
+        //! Copy the db in a frozen trie (only for a db stored in a Tatree)
+        void freezeDB( Tatree<SetsType> & data ){ frozenDB.build( data ) ; }
+        void freezeDB( Tatree_base<SetsType> & data ){ frozenDB.build( data ) ; }
+
+        //! Other data structures are not frozen
+        template< class DataStructDB >
+        void freezeDB( DataStructDB & data ){}
+
+        //! Reduce the db wrt the last frequent itemsets found (only for a db stored in a Tatree)
+        /**
+            The candidates of the next level have k+1 items, and each of their items is in k of their subsets, ie in k frequent itemsets of size k.
+            So the items in less than k frequent itemsets of size k are deleted from the transactions,
+            and the transactions with less than k+1 items are deleted.
+            \param cand the candidates (the frequent itemsets of size k are the leaves of the last level)
+            \param data the db
+        */
+        template< class Cand_DataStruct, class SetsTypeDB >
+        void reduceDB( Cand_DataStruct & cand, Tatree_base<SetsTypeDB> & data ) ;
+        template< class Cand_DataStruct, class SetsTypeDB >
+        void reduceDB( Cand_DataStruct & cand, Tatree<SetsTypeDB> & data ){ reduceDB( cand, (Tatree_base<SetsTypeDB> &) data ) ; }
+
+        //! Other data structures are not reduced
+        template< class Cand_DataStruct, class DataStructDB >
+        void reduceDB( Cand_DataStruct & cand, DataStructDB & data ){}
+
+        //! Method used to count the support of a set of itemsets with several threads
+        /**
+            The subtries of the root of the db are shared between nbThreads threads.
+            Each thread has its own counters, which are added to the nodes at the end.
+            \param head root of the trie storing the itemsets
+            \param itData iterator on the root of the data
+        */
+        template< class Measure, class IteratorData >
+        void countParallel( Node<int, Measure> * head, IteratorData  itData  ) ;
+
+        //! Method used to add the private counters of the threads to the nodes (the counters are deleted)
+        /**
+            \param index index of the first counter of each node
+            \param locals the counters of each thread
+        */
+        template< class Measure >
+        void addCounts( unordered_map< Node<int,Measure> *, int > & index, vector< LocalCounts<Measure> * > & locals ) ;
+
+        //! Method used to give an index to the counters of each node of the trie
+        /**
+            \param currNode curent node of the trie storing the itemsets
+            \param index index of the first counter of each node
+            \param size number of counters already indexed
+            \return the number of counters indexed
+        */
+        template< class Measure >
+        int indexCounts( Node<int, Measure> * currNode, unordered_map< Node<int,Measure> *, int > & index, int size ) ;
+
+        //! Method used to count the support of a set of itemsets in a db stored in a trie
+        /**
+            \param head root of the trie storing the itemsets
+            \param data the db
+        */
+        template< class Measure, class DataStructDB >
+        void countDB( Node<int, Measure> * head, DataStructDB & data ) ;
+
+        //! Method used to count the support of a set of itemsets in a vertical db
+        /**
+            \param head root of the trie storing the itemsets
+            \param data the db
+        */
+        template< class Measure, class SetsTypeDB >
+        void countDB( Node<int, Measure> * head, VerticalDB<SetsTypeDB> & data ) ;
+
+        //! Method used to count the support of a set of itemsets with the bitmaps of a vertical db
+        /**
+            The support of an itemset is the number of bits set in the intersection of the bitmap of its prefix
+            and the bitmap of its last item.
+            \param currNode curent node of the trie storing the itemsets
+            \param data the db
+            \param prefix bitmap of the transactions containing the prefix of the itemsets of the node (0 for the root)
+        */
+        template< class Measure, class SetsTypeDB >
+        void countBitmaps( Node<int, Measure> * currNode, VerticalDB<SetsTypeDB> & data, typename VerticalDB<SetsTypeDB>::Bitmap * prefix ) ;
+
     protected:
     
         //! Internal encoding of the items    
         RecodeToInt<SetsType> recode ;
         
+        //! Read only copy of the db, used to count the supports (empty if the db is not frozen)
+        FrozenTatree<SetsType> frozenDB ;
+        
         //! The transactionnal database    
         Data * db; 
         
@@ -170,24 +447,62 @@ class Frequent: public Predicate
         
     public: 
             
-        bool verbose ; // to print to screen 
-            
+        bool verbose ; // to print to screen
+
+        //! Number of threads used to count the support (1 by default, ie no thread)
+        int nbThreads ;
+
+        //! Boolean to count the support on a flat copy of the candidates (default false)
+        /**
+            The candidates are copied in a FlatPTree before counting and the supports are copied back after.
+            Only used when the support is counted without thread.
+        */
+        bool flat ;
+
+        //! Boolean to freeze the db after its reconstruction (default false)
+        /**
+            The db is copied in a FrozenTatree, which is then used to count the supports (only for a db stored in a Tatree).
+        */
+        bool freeze ;
+
+        //! Boolean to reduce the db after each level (default false)
+        /**
+            After the postProcessing of a level k > 1, the items which cannot be in a candidate of the next level
+            and the transactions with less than k+1 items are deleted from the db (only for a db stored in a Tatree).
+            Only valid for a levelwise exploration of the itemsets (Apriori), not when the next itemsets counted
+            are not generated from the frequent itemsets of the last level (Abs).
+        */
+        bool reduce ;
+
         //! List of all the items with their support
         /**
             Used to avoid support counting for items since in the initialization functor the items support is processed.
             Set in the initialization functor.
         */    
         listItemSupp   listItemSupport ;     
+
+        //! Support of each item
+        /**
+            Used to access in constant time to the support of the items.
+            Set in the initialization functor.
+        */    
+        mapItemSupp   itemSupport ;     
                             
         //! Constructor
         /**
             \param indb the transactional database
             \param inMinsup the absolute minimum support threshold
         */
-        Frequent( Data & indb, int inMinsup ){ db = & indb ; minsup = inMinsup; verbose = false; }
+        Frequent( Data & indb, int inMinsup ){ db = & indb ; minsup = inMinsup; verbose = false; nbThreads = 1; flat = false; freeze = false; reduce = false; }
  
         //! Destructor
         ~Frequent(){}
+
+        //! Return the transactional database (after the postProcessing of the first level, the transactions only contain the frequent items recoded)
+        Data * getDB(){ return db ; }
+
+        //! Return the minimum support threshold (absolute)
+        int getMinsup(){ return minsup ; }
                 
         //! Operator that test if an itemet is frequent or not
         /**
@@ -199,7 +514,7 @@ class Frequent: public Predicate
         { 
              if( itemsetIt->size() == 1 ) // use the items process in the initialization phase
              {
-                 ItListItemSupp it = find_if( listItemSupport.begin(), listItemSupport.end(),  eqItemSupp( * itemsetIt->begin() ) );
+                 ItMapItemSupp it = itemSupport.find( * itemsetIt->begin() );
                  
                  mesCand.supp = it->second ;  
             
@@ -229,6 +544,7 @@ class Frequent: public Predicate
         /**
             Method used to reconstruct the db after discovery of frequent items.
             Prune from the transactions all the not frequent items.
+            For the next levels, reduce the db if reduce is true.
             \param cand container of words of the language.
             \param wordToset functor that eventually transforms itemsets
         */
@@ -251,16 +567,14 @@ void Frequent<Data,SetsType>::preProcessing( Cand_DataStruct & cand , f  wordToS
     clock_t start ;    
     
     // copy all the items and their encoding
-    recode = cand.recode ;
+    recode = *cand.recode ;
        
 	if(  cand.getHead() &&  cand.length() > 1 )  // do not count support for items
 	{
         
-    	int used = 0 ;
-        
         start = clock();
 
-      	used += count( cand.getHead(), db->data().beginRoot()  ) ;
+        countDB( cand.getHead(), db->data() ) ;
        	
        	if( verbose ) cout<<" Count ["<<(clock()-start)/CLOCKS_PER_SEC<<"s] ";
     
@@ -276,25 +590,53 @@ void Frequent<Data,SetsType>::preProcessing( Cand_DataStruct & cand , f  wordToS
 template< class Data, class SetsType > template< class Measure, class IteratorData > 
 int Frequent<Data,SetsType>::count(Node< int, Measure> * currNode, IteratorData  itData   )
 {
-    typedef Node<int,Measure> Node;
+    NodeCounts<Measure> counts ;
+    
+    count( currNode, itData, counts ) ;
+    
+    return 0 ;
+}
+
+//! Method used to count the support of a set of itemsets in some counters
+/**
+    \param currNode curent node of the trie storing the itemsets
+    \param itData iterator on the data
+    \param counts counters updated (the nodes or the private counters of a thread)
+*/    
+template< class Data, class SetsType > template< class Measure, class IteratorData, class Counts > 
+void Frequent<Data,SetsType>::count(Node< int, Measure> * currNode, IteratorData  itData, Counts & counts   )
+{
     IteratorData   it = itData ;
 
     itData.rbeginChildNode();
    
-    if( currNode == 0 || itData == IteratorData() ) return 0;
+    if( currNode == 0 || itData == IteratorData() ) return ;
 
     while( itData !=  IteratorData() )      // count the transactions recursively  
     {
-        count( currNode, itData);
+        count( currNode, itData, counts );
         itData.rnextChild() ;
     }
     
-    int used=0 ;
-    int size ;
+    countItems( currNode, it, counts ) ;
+}
+
+//! Method used to count the support of a set of itemsets with the items stored in the children of a node of the db
+/**
+    \param currNode curent node of the trie storing the itemsets
+    \param itData iterator on the data
+    \param counts counters updated (the nodes or the private counters of a thread)
+*/    
+template< class Data, class SetsType > template< class Measure, class IteratorData, class Counts > 
+void Frequent<Data,SetsType>::countItems(Node< int, Measure> * currNode, IteratorData  it, Counts & counts   )
+{
+    typedef Node<int,Measure> Node;
+    
     int i;
     int n;
+    int base = counts.base( currNode ) ;
 
-    vector< Node *> * childs = currNode->getChilds(); 
+    typename Node::vectN * childs = currNode->getChilds(); 
 
 
     if( ! childs  || childs->empty() )
@@ -307,12 +649,12 @@ int Frequent<Data,SetsType>::count(Node< int, Measure> * currNode, IteratorData
         {
             i = it.elementId() - n  ;   // traverse the items  
             
-            if( i < 0 ) return used;        // if before first item, abort  
+            if( i < 0 ) return ;        // if before first item, abort  
             
             if(  i < currNode->getCnts()->size() 
                   &&  currNode->existVal( i ) && currNode->getCnts()->at(i).presence )       // if inside the counter range  and the support has not already been updated
             {                 
-                  currNode->getMeasure(i)=currNode->getMeasure(i)+Measure(1,it.measure() ); 
+                  counts.add( currNode, base, i, it.measure() ); 
             }
             
             it.rnextChild() ;
@@ -331,26 +673,397 @@ int Frequent<Data,SetsType>::count(Node< int, Measure> * currNode, IteratorData
         {               
             i = it.elementId() -n;   // traverse the items  
       
-            if (i < 0 ) return used ;      // if before first item, abort                               
+            if (i < 0 ) return ;      // if before first item, abort                               
             
             if ( ( i < childs->size() ) && ( next = (*childs)[i] ) )
             {
                                                
-               count( next, it );
+               count( next, it, counts );
             }
             else              
             if(  i < currNode->getCnts()->size() 
                       &&  currNode->existVal( i ) && currNode->getCnts()->at(i).presence )       // if inside the counter range  and the support has not already been updated 
             {
-                  currNode->getMeasure(i)=currNode->getMeasure(i)+Measure(1,it.measure() ); 
+                  counts.add( currNode, base, i, it.measure() ); 
             }     
               
             it.rnextChild() ;  
         }                           // if the child exists,  
     }                               // count the transaction recursively  
-    return used;
 }
 
+//! Method used to count the support of a set of itemsets stored in a flat trie
+/**
+    \param tree the trie storing the itemsets
+    \param currNode index of the curent node of the trie
+    \param itData iterator on the data
+*/    
+template< class Data, class SetsType > template< class Measure, class IteratorData > 
+void Frequent<Data,SetsType>::countFlat( FlatPTree<int, Measure> & tree, int currNode, IteratorData  itData )
+{
+    IteratorData   it = itData ;
+
+    itData.rbeginChildNode();
+   
+    if( tree.nbNodes() == 0 || itData == IteratorData() ) return ;
+
+    while( itData !=  IteratorData() )      // count the transactions recursively  
+    {
+        countFlat( tree, currNode, itData );
+        itData.rnextChild() ;
+    }
+    
+    countFlatItems( tree, currNode, it ) ;
+}
+
+//! Method used to count the support of a set of itemsets stored in a flat trie with the items stored in the children of a node of the db
+/**
+    \param tree the trie storing the itemsets
+    \param currNode index of the curent node of the trie
+    \param itData iterator on the data
+*/    
+template< class Data, class SetsType > template< class Measure, class IteratorData > 
+void Frequent<Data,SetsType>::countFlatItems( FlatPTree<int, Measure> & tree, int currNode, IteratorData  it )
+{
+    int i;
+    int next;
+    int n = tree.node( currNode ).offset ;
+    int size = tree.node( currNode ).size ;
+    
+    it.rbeginChildNode();
+
+    while( it !=  IteratorData() )
+    {               
+        i = it.elementId() - n;   // traverse the items  
+  
+        if( i < 0 ) return ;      // if before first item, abort                               
+        
+        if( i < size )
+        {
+            if( ( next = tree.child( currNode, i ) ) )  // if the child exists, count the transaction recursively
+                countFlat( tree, next, it );
+            else if( tree.exist( currNode, i ) && tree.measure( currNode, i ).presence ) // the support has not already been updated 
+            {
+                Measure & m = tree.measure( currNode, i ) ;
+                m = m + Measure( 1, it.measure() ) ;
+            }
+        }
+          
+        it.rnextChild() ;  
+    }
+}
+
+//! Method used to count the support of a set of itemsets in the frozen copy of the db
+/**
+    \param head root of the trie storing the itemsets
+*/    
+template< class Data, class SetsType > template< class Measure > 
+void Frequent<Data,SetsType>::countFrozen( Node< int, Measure> * head )
+{
+    typedef Node<int,Measure> Node;
+    
+    if( head == 0 || frozenDB.empty() ) return ;
+    
+    NodeCounts<Measure> counts ;
+    vector< pair< Node *, int > > stack ;
+    
+    if( nbThreads <= 1 )
+    {
+        stack.push_back( make_pair( head, 0 ) ) ;
+        countFrozen( stack, counts ) ;
+        return ;
+    }
+    
+    // the pairs of the root nodes are the tasks of the threads
+    countFrozenStep( head, 0, stack, counts ) ;
+    
+    unordered_map< Node *, int > index ;
+    int size = indexCounts( head, index, 0 ) ;
+    
+    atomic<int> next( 0 ) ;
+    vector< LocalCounts<Measure> * > locals ;
+    vector< thread > threads ;
+    
+    for( int t = 0 ; t < nbThreads ; t++ )
+    {
+        locals.push_back( new LocalCounts<Measure>( &index, size ) ) ;
+        threads.push_back( thread( countFrozenThread<Measure>( this, &stack, &next, locals.back() ) ) ) ;
+    }
+    
+    for( int t = 0 ; t < nbThreads ; t++ )
+        threads[ t ].join() ;
+    
+    addCounts( index, locals ) ;
+}
+
+//! Method used to count the support of the itemsets of the pairs (node of the candidates, node of the db) of a stack
+/**
+    \param stack the pairs to process (empty at the end)
+    \param counts counters updated (the nodes or the private counters of a thread)
+*/    
+template< class Data, class SetsType > template< class Measure, class Counts > 
+void Frequent<Data,SetsType>::countFrozen( vector< pair< Node<int,Measure> *, int > > & stack, Counts & counts )
+{
+    while( ! stack.empty() )
+    {
+        pair< Node<int,Measure> *, int > top = stack.back() ;
+        stack.pop_back() ;
+        countFrozenStep( top.first, top.second, stack, counts ) ;
+    }
+}
+
+//! Method used to process a pair (node of the candidates, node of the db)
+/**
+    The itemsets of the node of the candidates are searched in the subtries of the child nodes of the db (their element is skipped),
+    and the element of each child node of the db is searched in the node of the candidates 
+    (it is counted if this is a leaf, else its child node is processed with the child node of the db).
+    \param currNode the node of the candidates
+    \param index index of the node of the db
+    \param stack the pairs to process
+    \param counts counters updated (the nodes or the private counters of a thread)
+*/    
+template< class Data, class SetsType > template< class Measure, class Counts > 
+void Frequent<Data,SetsType>::countFrozenStep( Node<int,Measure> * currNode, int index, vector< pair< Node<int,Measure> *, int > > & stack, Counts & counts )
+{
+    typedef Node<int,Measure> Node;
+    typedef typename FrozenTatree<SetsType>::FrozenNode FrozenNode;
+    
+    const FrozenNode & dbNode = frozenDB.node( index ) ;
+    int first = dbNode.first ;
+    int last = dbNode.first + dbNode.nb - 1 ;
+    int c ;
+    
+    // search the itemsets in the subtries of the child nodes of the db
+    for( c = last ; c >= first ; c-- )
+    {
+        if( frozenDB.node( c ).nb )
+        {
+            #ifdef __GNUC__
+            __builtin_prefetch( & frozenDB.node( frozenDB.node( c ).first ) ) ;
+            #endif
+            stack.push_back( make_pair( currNode, c ) ) ;
+        }
+    }
+    
+    // search the elements of the child nodes of the db in the current node
+    typename Node::vectT * cnts = currNode->getCnts() ;
+    typename Node::vectN * childs = currNode->getChilds() ;
+    int n = currNode->getOffset() ;
+    int size = cnts ? cnts->size() : 0 ;
+    int base = counts.base( currNode ) ;
+    int i ;
+    Node * next ;
+    
+    for( c = last ; c >= first ; c-- )
+    {
+        const FrozenNode & dbChild = frozenDB.node( c ) ;
+        
+        i = dbChild.item - n ;   // traverse the items  
+        
+        if( i < 0 ) break ;      // if before first item, abort
+        
+        if( childs && i < childs->size() && ( next = (*childs)[i] ) )
+        {
+            if( dbChild.nb ) // the itemsets of the child node are searched in the subtrie
+                stack.push_back( make_pair( next, c ) ) ;
+        }
+        else if( i < size && currNode->existVal( i ) && (*cnts)[i].presence ) // if inside the counter range  and the support has not already been updated
+        {
+            counts.add( currNode, base, i, dbChild.cnt ) ; 
+        }
+    }
+}
+
+//! Method used to count the support of a set of itemsets with several threads
+/**
+    The subtries of the root of the db are shared between nbThreads threads.
+    Each thread has its own counters, which are added to the nodes at the end.
+    \param head root of the trie storing the itemsets
+    \param itData iterator on the root of the data
+*/    
+template< class Data, class SetsType > template< class Measure, class IteratorData > 
+void Frequent<Data,SetsType>::countParallel(Node< int, Measure> * head, IteratorData  itData   )
+{
+    typedef Node<int,Measure> Node;
+    
+    if( head == 0 ) return ;
+    
+    // index the counters of the nodes
+    unordered_map< Node *, int > index ;
+    int size = indexCounts( head, index, 0 ) ;
+    
+    // each subtrie of the root of the db is a task
+    vector< IteratorData > tasks ;
+    IteratorData it = itData ;
+    it.rbeginChildNode();
+    while( it !=  IteratorData() )
+    {
+        tasks.push_back( it ) ;
+        it.rnextChild() ;
+    }
+    
+    atomic<int> next( 0 ) ;
+    vector< LocalCounts<Measure> * > locals ;
+    vector< thread > threads ;
+    
+    for( int t = 0 ; t < nbThreads ; t++ )
+    {
+        locals.push_back( new LocalCounts<Measure>( &index, size ) ) ;
+        threads.push_back( thread( countThread<Measure,IteratorData>( this, head, itData, &tasks, &next, locals.back() ) ) ) ;
+    }
+    
+    for( int t = 0 ; t < nbThreads ; t++ )
+        threads[ t ].join() ;
+    
+    addCounts( index, locals ) ;
+}
+
+//! Method used to add the private counters of the threads to the nodes (the counters are deleted)
+/**
+    \param index index of the first counter of each node
+    \param locals the counters of each thread
+*/    
+template< class Data, class SetsType > template< class Measure > 
+void Frequent<Data,SetsType>::addCounts( unordered_map< Node<int,Measure> *, int > & index, vector< LocalCounts<Measure> * > & locals )
+{
+    typedef Node<int,Measure> Node;
+    typedef typename unordered_map< Node *, int >::iterator ItIndex ;
+    
+    // sum the counters of the threads
+    vector<int> & cnts = locals[ 0 ]->cnts ;
+    for( int t = 1 ; t < locals.size() ; t++ )
+    {
+        for( int c = 0 ; c < cnts.size() ; c++ )
+             cnts[ c ] += locals[ t ]->cnts[ c ] ;
+        delete locals[ t ] ;
+    }
+
+    // update the support of the nodes
+    for( ItIndex itIndex = index.begin() ; itIndex != index.end() ; ++itIndex )
+    {
+        Node * currNode = itIndex->first ;
+        int n = currNode->getCnts() ? currNode->getCnts()->size() : 0 ;
+        for( int i = 0 ; i < n ; i++ )
+        {
+            if( cnts[ itIndex->second + i ] ) 
+                currNode->getMeasure(i)=currNode->getMeasure(i)+Measure(1,cnts[ itIndex->second + i ] ); 
+        }
+    }
+    
+    delete locals[ 0 ] ;
+    locals.clear() ;
+}
+
+//! Method used to give an index to the counters of each node of the trie
+/**
+    \param currNode curent node of the trie storing the itemsets
+    \param index index of the first counter of each node
+    \param size number of counters already indexed
+    \return the number of counters indexed
+*/    
+template< class Data, class SetsType > template< class Measure > 
+int Frequent<Data,SetsType>::indexCounts(Node< int, Measure> * currNode, unordered_map< Node<int,Measure> *, int > & index, int size )
+{
+    typedef Node<int,Measure> Node;
+    
+    index[ currNode ] = size ;
+    if( currNode->getCnts() )
+        size += currNode->getCnts()->size() ;
+    
+    typename Node::vectN * childs = currNode->getChilds(); 
+    if( childs )
+    {
+        for( int i = 0 ; i < childs->size() ; i++ )
+             if( (*childs)[ i ] )
+                 size = indexCounts( (*childs)[ i ], index, size ) ;
+    }
+    
+    return size ;
+}
+
+//! Method used to count the support of a set of itemsets in a db stored in a trie
+/**
+    \param head root of the trie storing the itemsets
+    \param data the db
+*/    
+template< class Data, class SetsType > template< class Measure, class DataStructDB > 
+void Frequent<Data,SetsType>::countDB( Node< int, Measure> * head, DataStructDB & data )
+{
+    if( ! frozenDB.empty() )
+        countFrozen( head ) ;
+    else if( nbThreads > 1 )
+        countParallel( head, data.beginRoot()  ) ;
+    else if( flat )
+    {
+        FlatPTree<int,Measure> tree( head ) ;
+        countFlat( tree, 0, data.beginRoot() ) ;
+        tree.storeMeasures() ;
+    }
+    else
+        count( head, data.beginRoot()  ) ;
+}
+
+//! Method used to count the support of a set of itemsets in a vertical db
+/**
+    \param head root of the trie storing the itemsets
+    \param data the db
+*/    
+template< class Data, class SetsType > template< class Measure, class SetsTypeDB > 
+void Frequent<Data,SetsType>::countDB( Node< int, Measure> * head, VerticalDB<SetsTypeDB> & data )
+{
+    countBitmaps( head, data, 0 ) ;
+}
+
+//! Method used to count the support of a set of itemsets with the bitmaps of a vertical db
+/**
+    The support of an itemset is the number of bits set in the intersection of the bitmap of its prefix
+    and the bitmap of its last item.
+    \param currNode curent node of the trie storing the itemsets
+    \param data the db
+    \param prefix bitmap of the transactions containing the prefix of the itemsets of the node (0 for the root)
+*/    
+template< class Data, class SetsType > template< class Measure, class SetsTypeDB > 
+void Frequent<Data,SetsType>::countBitmaps( Node< int, Measure> * currNode, VerticalDB<SetsTypeDB> & data, typename VerticalDB<SetsTypeDB>::Bitmap * prefix )
+{
+    typedef Node<int,Measure> Node;
+    typedef typename VerticalDB<SetsTypeDB>::Bitmap Bitmap;
+    
+    if( currNode == 0 || currNode->getCnts() == 0 ) return ;
+    
+    typename Node::vectN * childs = currNode->getChilds(); 
+    int n = currNode->getOffset() ;
+    int size = currNode->getCnts()->size() ;
+    int supp ;
+    Node * next ;
+    
+    // bitmap of the prefix of the itemsets of the child nodes
+    Bitmap inter ;
+    
+    for( int i = 0 ; i < size && n + i < data.nbElements() ; i++ )
+    {
+        next = ( childs && i < childs->size() ) ? (*childs)[i] : 0 ;
+        
+        if( next ) // the itemset has been counted, count the itemsets of the child node
+        {
+            if( prefix )
+            {
+                VerticalDB<SetsTypeDB>::intersect( *prefix, data.bitmap( n + i ), &inter ) ;
+                countBitmaps( next, data, &inter ) ;
+            }
+            else
+                countBitmaps( next, data, &data.bitmap( n + i ) ) ;
+        }
+        else if( prefix && currNode->existVal( i ) && currNode->getCnts()->at(i).presence ) // the support has not already been updated
+        {
+            supp = VerticalDB<SetsTypeDB>::intersect( *prefix, data.bitmap( n + i ) ) ;
+            
+            if( supp )
+                currNode->getMeasure(i)=currNode->getMeasure(i)+Measure(1,supp ); 
+        }
+    }
+}
+
+
 //! Function used to do some post processing operations after testing the candidates generated.
 /**
     Method used to reconstruct the db after discovery of frequent items.
@@ -367,16 +1080,49 @@ void Frequent<Data,SetsType>::postProcessing( Cand_DataStruct & cand, f  wordToS
 
             clock_t start = clock();            
                              
-            // reorder the transactions of the data base (decreasing order of support)
-            // each transaction is read,
-            // recoded (same reconding than the one for the candidates) and re inserted in the data base
-            reorderTrans  reorder( db, listItemSupport.size(), &recode ); 
-            for_each( db->begin(), db->end(), reorder  ) ; 
+            if( db->cached() )
+            {
+                // the transactions of the cache are already recoded (same recoding than the one for the candidates)
+                // and sorted, so only the unfrequent items are deleted before inserting them in the data base
+                DBCache<SetsType> & cache = *db->getCache() ;
+                int nbnotfreq = recode.size() - listItemSupport.size() ;
+                
+                vector<bool> isfreq( cache.nbItems() ) ;
+                for( int i = 0 ; i < cache.nbItems() ; i++ )
+                {
+                     typename map<SetsType,int>::iterator itmap = recode.getIdTointernid()->find( cache.item( i ) ) ;
+                     isfreq[ i ] = ( itmap != recode.getIdTointernid()->end() &&  itmap->second >= nbnotfreq ) ;
+                }
+                
+                vector<int> trans ;
+                for( int t = 0 ; t < cache.nbTransactions() ; t++ )
+                {
+                     trans.resize( 0 ) ;
+                     for( const int * item = cache.begin( t ) ; item != cache.end( t ) ; ++item )
+                          if( isfreq[ *item ] )
+                              trans.push_back( *item ) ;
+                     db->push_back( trans ) ;
+                }
+                
+                db->releaseCache() ;
+            }
+            else
+            {
+                // reorder the transactions of the data base (decreasing order of support)
+                // each transaction is read,
+                // recoded (same reconding than the one for the candidates) and re inserted in the data base
+                reorderTrans  reorder( db, listItemSupport.size(), &recode ); 
+                for_each( db->begin(), db->end(), reorder  ) ; 
+            }
             
             RecodeToInt<SetsType> * recodeData = new RecodeToInt<SetsType>() ;
             *recodeData = recode ;
             // set the recode function
             db->setRecode( recodeData );
+            
+            // the db is not modified anymore
+            if( freeze )
+                freezeDB( db->data() ) ;
              
             if( verbose ) 
             {                             
@@ -384,7 +1130,46 @@ void Frequent<Data,SetsType>::postProcessing( Cand_DataStruct & cand, f  wordToS
             }
 
      }       
+     else if( reduce && cand.getHead() )
+     {
+            clock_t start = clock();
+
+            reduceDB( cand, db->data() ) ;
+
+            if( freeze )
+                freezeDB( db->data() ) ;
+
+            if( verbose ) cout<<" Reduce data ["<<(clock()-start)/CLOCKS_PER_SEC<<"s] Trans:"<<db->data().size() ;
+     }
+
+}
+
+//! Reduce the db wrt the last frequent itemsets found (only for a db stored in a Tatree)
+/**
+    The candidates of the next level have k+1 items, and each of their items is in k of their subsets, ie in k frequent itemsets of size k.
+    So the items in less than k frequent itemsets of size k are deleted from the transactions,
+    and the transactions with less than k+1 items are deleted.
+    \param cand the candidates (the frequent itemsets of size k are the leaves of the last level)
+    \param data the db
+*/
+template< class Data, class SetsType > template< class Cand_DataStruct, class SetsTypeDB >
+void Frequent<Data,SetsType>::reduceDB( Cand_DataStruct & cand, Tatree_base<SetsTypeDB> & data )
+{
+     int k = cand.length() ;
+
+     // number of frequent itemsets of size k containing each item
+     vector<int> occ( cand.recode->size(), 0 ) ;
+
+     for( typename Cand_DataStruct::iterator itLeaf = cand.beginLeaf() ; itLeaf != cand.end() ; itLeaf = itLeaf.nextLeaf() )
+          if( itLeaf.length() == k )
+              for( typename Cand_DataStruct::iterator it = itLeaf ; it != typename Cand_DataStruct::iterator() && it.elementId() != -1 ; it = it.parentNode() )
+                   occ[ it.elementId() ]++ ;
+
+     vector<bool> keep( occ.size() ) ;
+     for( int i = 0 ; i < (int) occ.size() ; i++ )
+          keep[ i ] = occ[ i ] >= k ;
 
+     data.reduce( keep, k + 1 ) ;
 }
 
 
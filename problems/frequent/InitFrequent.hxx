@@ -22,6 +22,7 @@
 #define INITFREQUENT_HXX
 
 #include <utility>
+#include <unordered_map>
 
 #include "RecodeToInt.hxx"
 
@@ -45,38 +46,47 @@ class InitFrequent
         typedef typename   listItemSupp::iterator ItListItemSupp ;
         typedef typename   listItemSupp::reverse_iterator revItListItemSupp ;
              
+        typedef  unordered_map<SetsType, int> mapItemSupp ;
+        typedef typename   mapItemSupp::iterator ItMapItemSupp ;
+             
         //! Functor extracting all the items of the container of the db and updating their support.    
         class searchFIDB 
         {
                 //! items store the items with their support
-                listItemSupp * items ;
+                mapItemSupp * items ;
+                
+                //! the items in the order they are discovered
+                vector<SetsType> * order ;
                 
             public:
                                                     
-                searchFIDB( listItemSupp * initems ){ items =  initems; }            
+                searchFIDB( mapItemSupp * initems, vector<SetsType> * inorder ){ items =  initems; order = inorder; }            
                 
                 template< class T1 >     
-                void operator() (T1 x) { for_each( x.begin(), x.end(), searchFITrans( items )  ); }
+                void operator() (T1 & x) { for_each( x.begin(), x.end(), searchFITrans( items, order )  ); }
         };   
          
         //! Functor extracting all the items of a transaction and updating their support.
         class searchFITrans 
         {
                 //! items store the items with their support
-                listItemSupp * items ;
+                mapItemSupp * items ;
+                
+                //! the items in the order they are discovered
+                vector<SetsType> * order ;
                 
             public:
                                                     
-                searchFITrans( listItemSupp * initems ){ items = initems; }            
+                searchFITrans( mapItemSupp * initems, vector<SetsType> * inorder ){ items = initems; order = inorder; }            
                 
-                void operator() (SetsType x) 
+                void operator() ( const SetsType & x) 
                 {            
-                    ItListItemSupp it = find_if( items->begin(), items->end(), eqItemSupp(x) )  ;
+                    pair< ItMapItemSupp, bool > it = items->insert( make_pair( x, 0 ) ) ;
                     
-                    if( it == items->end() ) // the items was not dicovered
-                         items->push_back( make_pair( x, 1 ) );
-                    else // update the support
-                         it->second++;        
+                    if( it.second ) // the items was not dicovered
+                         order->push_back( x );
+                    
+                    it.first->second++; // update the support
                 }
         };               
         
@@ -128,11 +138,30 @@ void InitFrequent<SetsType, BinaryDB, Predicate>::operator() ()
     int nbElements = 0;
     clock_t start = clock();
     
-    // extract items and their support
-    for_each( db->begin(), db->end(), searchFIDB( & (pred->listItemSupport) ) ) ; 
+    if( db->cached() ) // the items and their support are read in the cache (already in increasing order of support)
+    {
+        DBCache<SetsType> * cache = db->getCache() ;
+        for( int i = 0 ; i < cache->nbItems() ; i++ )
+        {
+             pred->itemSupport[ cache->item( i ) ] = cache->support( i ) ;
+             pred->listItemSupport.push_back( make_pair( cache->item( i ), cache->support( i ) ) ) ; 
+        }
+    }
+    else
+    {
+        // extract items and their support
+        vector<SetsType> order ;
+        for_each( db->begin(), db->end(), searchFIDB( & (pred->itemSupport), & order ) ) ; 
 
-    // reorder items (increasing order of support)
-    pred->listItemSupport.sort( lessItemSupp() ); 
+        for( int i = 0 ; i < order.size() ; i++ )
+             pred->listItemSupport.push_back( make_pair( order[ i ], pred->itemSupport[ order[ i ] ] ) ) ; 
+
+        // reorder items (increasing order of support)
+        pred->listItemSupport.sort( lessItemSupp() ); 
+        
+        // save the db preprocessed for the next runs (if a cache is used)
+        db->saveCache( pred->listItemSupport ) ;
+    }
                 
     // recode items and insert in the candidates data structure in the specified order
     ItListItemSupp it= pred->listItemSupport.begin();
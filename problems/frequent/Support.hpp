@@ -61,4 +61,7 @@ Support operator + ( const Support & s1, const Support & s2 ) { return Support(
 
 ostream & operator<<( ostream & os, const Support & inval ) { os << inval.supp; return os; }
 
+//! Value written in a file for a support (used by FimiFileBuffered to write it as an integer)
+inline int outputValue( const Support & inval ) { return inval.supp; }
+
 #endif
@@ -54,27 +54,22 @@ class Key_base: public Predicate
         int countProjection( Iterator itCand ) ;
               
         //! Functor used to projet all the tuples wrt attributes studied 
-        template< class Iterator>
         class ProcessTuples
         {            
-                 //! Iterator on the candidate 
-                 Iterator * itcand;      
+                 //! Number of the attributes of the candidate
+                 vector<int> * cand;      
                  
                  //! Store all the tuple sprojected wrt the candidate
                  PTree<int,bool> * projectTrie;
                  
                  vector<int> tupleProjected;
-                 
-                 RecodeToInt< AttributeType > * numAttrib ;
             
             public:
-                 ProcessTuples( Iterator * initcand, PTree<int,bool> * inproject, RecodeToInt< AttributeType > * innumAttrib  ){ itcand=initcand; projectTrie = inproject; numAttrib=innumAttrib; }
+                 ProcessTuples( vector<int> * incand, PTree<int,bool> * inproject ){ cand=incand; projectTrie = inproject; }
                  
                  template< class ContainerTuple >
                  void operator() ( ContainerTuple &  tuple)
                  {
-                      vector<int> * cand = & (*numAttrib)(**itcand);
-
                       tupleProjected.resize( 0 );
                       tupleProjected.reserve( cand->size() );                      
 
@@ -152,14 +147,28 @@ class Key_base: public Predicate
 //! function used to count the projection of a candidates pointed by the iterator passed in parameter.            
 /*!
     \param itCand iterator on the candidate to test.
-    \return the cardinality of the projection.
+    \return the cardinality of the projection (-1 if an attribute is not in the relation).
 */ 
 template< class Data, class AttributeType  >  template< class Iterator  >                  
 int Key_base<Data,AttributeType>::countProjection( Iterator   itCand ) 
 {
      PTree<int, bool > tuplesProjection;
      
-     for_each( table->begin(), table->end(), ProcessTuples<Iterator>( &itCand, &tuplesProjection,&numAttrib  ) );
+     // the numbers of the attributes are searched once for all the tuples, without modifying numAttrib
+     // (so that several candidates can be tested at the same time)
+     vector<AttributeType> & attributes = *itCand ;
+     map< AttributeType, int > * ids = numAttrib.getIdTointernid() ;
+     vector<int> cand ;
+     cand.reserve( attributes.size() ) ;
+     for( typename vector<AttributeType>::iterator it = attributes.begin() ; it != attributes.end() ; ++it )
+     {
+          typename map< AttributeType, int >::iterator itId = ids->find( *it ) ;
+          if( itId == ids->end() ) // unknown attribute
+              return -1 ;
+          cand.push_back( itId->second ) ;
+     }
+     
+     for_each( table->begin(), table->end(), ProcessTuples( &cand, &tuplesProjection ) );
 
      return   tuplesProjection.size()  ;     
 }
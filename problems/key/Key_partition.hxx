@@ -0,0 +1,346 @@
+/*
+ *  Copyright (C) 2006 Frdric Flouvat
+ *  Written by Frdric Flouvat
+ *  Updated by Frdric Flouvat
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  59 Temple Place, Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef KEY_PARTITION_HXX
+#define KEY_PARTITION_HXX
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+
+#include "Predicate.hxx"
+#include "PTree.hxx"
+
+
+//! Functor representing the predicate being a super key, using stripped partitions (as in TANE).
+/*!
+    This functor test if an itemset is a super key, as Key_base, but without projecting the relation for each candidate.
+    The method used is the following one:
+        * the partition of the tuples wrt each attribute (the tuples with the same value are in the same class) is computed once.
+        * only the classes of at least 2 tuples are stored (stripped partitions).
+        * the partition wrt a set of attributes X is the product of the partitions of two subsets of X
+          (X without its last attribute, and X without its last but one attribute or the last attribute alone).
+        * the number of distinct projections wrt X is the number of tuples minus the sum, for each class, of the size of the class minus 1.
+        * the candidate is a super key if this number is equal to the number of distinct tuples of the relation.
+
+    The partitions computed are stored in a cache, so that the partitions of the next candidates are obtained from the cached ones.
+    When the cache is full, the oldest partitions are removed (they are the partitions of the precedent levels in a levelwise exploration).
+    If a partition is not in the cache (with Abs or a top down exploration), it is computed recursively from the partitions of the attributes.
+
+    The cache is protected by a lock, so the candidates can be tested by several threads (see Apriori::nbPredicateThreads).
+
+    The template parameter Data is the type of the tablular data.
+    The template parameter AttributeType is the type of the attributes.
+    \see Key_base
+*/
+template< class Data, class AttributeType >
+class Key_partition: public Predicate
+{
+    protected:
+
+        //! Stripped partition of the tuples wrt a set of attributes
+        /**
+            The tuples of the i-th class are stored in tuples, from ends[ i-1 ] (0 for the first class) to ends[ i ].
+        */
+        struct Partition
+        {
+            //! the tuples of all the classes
+            vector<int> tuples ;
+
+            //! the end of each class in tuples
+            vector<int> ends ;
+
+            //! Return the number of tuples which are not distinct of the first tuple of their class
+            int error() const { return tuples.size() - ends.size() ; }
+        };
+
+        //! Number of tuples
+        int nbTuples ;
+
+        //! Number of distinct tuples
+        int nbDistTuples ;
+
+        //! Used to get the numero of the attributes ( 1st, 2nd,...).
+        RecodeToInt< AttributeType > numAttrib ;
+
+        //! Partition of each attribute
+        vector< Partition > attribPartitions ;
+
+        //! Partitions of the sets of attributes already computed (the sets of at least 2 attributes)
+        map< vector<int>, shared_ptr< const Partition > > cache ;
+
+        //! Sets of attributes of the cache, in the order they have been inserted
+        deque< vector<int> > cacheOrder ;
+
+        //! Number of integers stored in the cache
+        long cacheSize ;
+
+        //! Lock used to access the cache
+        mutex lock ;
+
+        //! Compute the product of two partitions
+        /**
+            \param p1 the first partition
+            \param p2 the second partition
+            \param result stores the classes of tuples in the same class in p1 and in p2
+        */
+        void product( const Partition & p1, const Partition & p2, Partition & result ) ;
+
+        //! Return the partition of a set of attributes (from the cache, or computed and inserted in the cache)
+        /**
+            \param attribs the numbers of the attributes (sorted)
+        */
+        shared_ptr< const Partition > partition( vector<int> & attribs ) ;
+
+        //! Return the partition of a set of attributes if it is in the cache (0 otherwise)
+        shared_ptr< const Partition > find( vector<int> & attribs ) ;
+
+        //! Insert the partition of a set of attributes in the cache (and remove the oldest partitions if the cache is full)
+        void insert( vector<int> & attribs, shared_ptr< const Partition > part ) ;
+
+    public:
+
+        //! Maximum number of integers (ids of the tuples) stored in the cache (by default 64M, ie 256MB)
+        long maxCacheSize ;
+
+        //! Constructor
+        template< class InputDBFormat >
+        Key_partition( Data & table, InputDBFormat & input )
+        {
+                  numAttrib(input.attributes) ;
+
+                  cacheSize = 0 ;
+                  maxCacheSize = 1L << 26 ;
+
+                  // the distinct tuples
+                  PTree<int, bool > tuplesProjection;
+                  for( typename Data::iterator it= table.begin(); it != table.end(); ++it )
+                       tuplesProjection.push_back( *it );
+                  nbDistTuples = tuplesProjection.size();
+
+                  // the partition of each attribute (the values of the tuples are grouped)
+                  attribPartitions.resize( input.attributes.size() ) ;
+                  for( int a = 0 ; a < input.attributes.size() ; a++ )
+                  {
+                       map< int, vector<int> > classes ;
+                       int t = 0 ;
+
+                       for( typename Data::iterator it= table.begin(); it != table.end(); ++it, ++t )
+                            classes[ (*it)[ a ] ].push_back( t ) ;
+
+                       for( map< int, vector<int> >::iterator itClass = classes.begin() ; itClass != classes.end() ; ++itClass )
+                            if( itClass->second.size() > 1 )
+                            {
+                                attribPartitions[ a ].tuples.insert( attribPartitions[ a ].tuples.end(), itClass->second.begin(), itClass->second.end() ) ;
+                                attribPartitions[ a ].ends.push_back( attribPartitions[ a ].tuples.size() ) ;
+                            }
+                  }
+
+                  nbTuples = table.size() ;
+        }
+
+        //! Destructor
+        ~Key_partition(){}
+
+        //! Operator that test if a set of attributes is a super key
+        template< class Iterator, class Measure >
+        bool operator() ( Iterator  itemsetIt, Measure & mesCand );
+
+};
+
+
+//! Compute the product of two partitions
+/**
+    \param p1 the first partition
+    \param p2 the second partition
+    \param result stores the classes of tuples in the same class in p1 and in p2
+*/
+template< class Data, class AttributeType  >
+void Key_partition<Data,AttributeType>::product( const Partition & p1, const Partition & p2, Partition & result )
+{
+     // buffers of the thread, the class of each tuple in p1 is -1 out of the product
+     static thread_local vector<int> classOf ;
+     static thread_local vector< vector<int> > newClasses ;
+     static thread_local vector<int> touched ;
+
+     if( classOf.size() < nbTuples )
+         classOf.resize( nbTuples, -1 ) ;
+     if( newClasses.size() < p1.ends.size() )
+         newClasses.resize( p1.ends.size() ) ;
+
+     int begin = 0 ;
+     for( int c = 0 ; c < p1.ends.size() ; c++ )
+     {
+          for( int i = begin ; i < p1.ends[ c ] ; i++ )
+               classOf[ p1.tuples[ i ] ] = c ;
+          begin = p1.ends[ c ] ;
+     }
+
+     // each class of p2 is split wrt the classes of p1
+     begin = 0 ;
+     for( int c = 0 ; c < p2.ends.size() ; c++ )
+     {
+          touched.resize( 0 ) ;
+
+          for( int i = begin ; i < p2.ends[ c ] ; i++ )
+          {
+               int c1 = classOf[ p2.tuples[ i ] ] ;
+               if( c1 != -1 )
+               {
+                   if( newClasses[ c1 ].empty() )
+                       touched.push_back( c1 ) ;
+                   newClasses[ c1 ].push_back( p2.tuples[ i ] ) ;
+               }
+          }
+          begin = p2.ends[ c ] ;
+
+          for( int i = 0 ; i < touched.size() ; i++ )
+          {
+               vector<int> & newClass = newClasses[ touched[ i ] ] ;
+               if( newClass.size() > 1 ) // the stripped partition does not contain the classes of one tuple
+               {
+                   result.tuples.insert( result.tuples.end(), newClass.begin(), newClass.end() ) ;
+                   result.ends.push_back( result.tuples.size() ) ;
+               }
+               newClass.resize( 0 ) ;
+          }
+     }
+
+     for( int i = 0 ; i < p1.tuples.size() ; i++ )
+          classOf[ p1.tuples[ i ] ] = -1 ;
+}
+
+//! Return the partition of a set of attributes if it is in the cache (0 otherwise)
+template< class Data, class AttributeType  >
+shared_ptr< const typename Key_partition<Data,AttributeType>::Partition > Key_partition<Data,AttributeType>::find( vector<int> & attribs )
+{
+     lock_guard< mutex > guard( lock ) ;
+
+     typename map< vector<int>, shared_ptr< const Partition > >::iterator it = cache.find( attribs ) ;
+
+     return it != cache.end() ? it->second : shared_ptr< const Partition >() ;
+}
+
+//! Insert the partition of a set of attributes in the cache (and remove the oldest partitions if the cache is full)
+template< class Data, class AttributeType  >
+void Key_partition<Data,AttributeType>::insert( vector<int> & attribs, shared_ptr< const Partition > part )
+{
+     lock_guard< mutex > guard( lock ) ;
+
+     if( ! cache.insert( make_pair( attribs, part ) ).second ) // already computed by another thread
+         return ;
+
+     cacheOrder.push_back( attribs ) ;
+     cacheSize += part->tuples.size() + part->ends.size() ;
+
+     while( cacheSize > maxCacheSize && cacheOrder.size() > 1 )
+     {
+          typename map< vector<int>, shared_ptr< const Partition > >::iterator it = cache.find( cacheOrder.front() ) ;
+          cacheSize -= it->second->tuples.size() + it->second->ends.size() ;
+          cache.erase( it ) ;
+          cacheOrder.pop_front() ;
+     }
+}
+
+//! Return the partition of a set of attributes (from the cache, or computed and inserted in the cache)
+/**
+    \param attribs the numbers of the attributes (sorted)
+*/
+template< class Data, class AttributeType  >
+shared_ptr< const typename Key_partition<Data,AttributeType>::Partition > Key_partition<Data,AttributeType>::partition( vector<int> & attribs )
+{
+     shared_ptr< const Partition > part = find( attribs ) ;
+     if( part )
+         return part ;
+
+     int last = attribs.back() ;
+
+     // the partition of the set without its last attribute
+     attribs.pop_back() ;
+     shared_ptr< const Partition > part1 = attribs.size() > 1 ? partition( attribs ) : shared_ptr< const Partition >() ;
+     const Partition & p1 = part1 ? *part1 : attribPartitions[ attribs.back() ] ;
+
+     // the partition of the set without its last but one attribute if it is in the cache (it is smaller than the partition of the last attribute)
+     shared_ptr< const Partition > part2 ;
+     if( attribs.size() > 1 )
+     {
+         int lastButOne = attribs.back() ;
+         attribs.back() = last ;
+         part2 = find( attribs ) ;
+         attribs.back() = lastButOne ;
+     }
+     const Partition & p2 = part2 ? *part2 : attribPartitions[ last ] ;
+
+     attribs.push_back( last ) ;
+
+     shared_ptr< Partition > result( new Partition ) ;
+     if( p1.ends.size() && p2.ends.size() ) // the product of a partition without class has no class
+         product( p1, p2, *result ) ;
+
+     insert( attribs, result ) ;
+
+     return result ;
+}
+
+//! Operator that test if a set of attributes is a super key
+/**
+    \param itCand iterator (or pointer) on the set of attributes to test wrt the predicate
+    \param mesCand cardinality of the projection on the db of the attributes
+*/
+template< class Data, class AttributeType  > template< class Iterator, class Measure>
+bool Key_partition<Data,AttributeType >::operator() ( Iterator    itCand, Measure & mesCand )
+{
+    vector<AttributeType> & attributes = *itCand ;
+
+    map< AttributeType, int > * ids = numAttrib.getIdTointernid() ;
+    vector<int> attribs ;
+    attribs.reserve( attributes.size() ) ;
+    for( typename vector<AttributeType>::iterator it = attributes.begin() ; it != attributes.end() ; ++it )
+    {
+         typename map< AttributeType, int >::iterator itId = ids->find( *it ) ;
+         if( itId == ids->end() ) // unknown attribute, the candidate is rejected
+             return false ;
+         attribs.push_back( itId->second ) ;
+    }
+    sort( attribs.begin(), attribs.end() ) ;
+
+    if( attribs.empty() ) // all the tuples have the same projection
+        return nbDistTuples <= 1 ;
+
+    int error ;
+    if( attribs.size() == 1 )
+        error = attribPartitions[ attribs[ 0 ] ].error() ;
+    else
+        error = partition( attribs )->error() ;
+
+    // the cardianlity of the projection wrt the attributes in the candidate tested
+    int cardProjectCand = nbTuples - error ;
+
+    if( cardProjectCand !=  nbDistTuples )
+        return false;
+
+    return true;
+}
+
+
+#endif